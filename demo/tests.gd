@@ -0,0 +1,120 @@
+extends Node
+
+# Checks of numerical edge cases that are easy to break when optimizing kernels.
+# Run with: godot --headless --path demo res://tests.tscn
+# Failed checks are printed as errors; the exit code is the number of failed checks.
+
+var failures := 0
+
+func _ready() -> void:
+	test_pairwise_sum()
+	test_moments_nan()
+	test_argmax_ties()
+	test_top_k_order()
+	test_moving_non_finite()
+	test_histogram_ranges()
+
+	if failures == 0:
+		print("All checks passed.")
+	get_tree().quit(failures)
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		push_error("Check failed: " + message)
+
+# Whether the values are equal, with NaN equal to NaN.
+func same_values(actual: NDArray, expected: Array) -> bool:
+	if actual == null:
+		return false
+	var values := actual.to_packed_float64_array()
+	if values.size() != expected.size():
+		return false
+	for i in values.size():
+		if is_nan(expected[i]):
+			if not is_nan(values[i]):
+				return false
+		elif values[i] != expected[i] and not is_equal_approx(values[i], expected[i]):
+			return false
+	return true
+
+func test_pairwise_sum() -> void:
+	# Adding 0.1 ten million times one by one in float32 is off by about 9%.
+	var a := nd.full(10_000_000, 0.1, nd.DType.Float32)
+	var total := nd.sum(a).to_float()
+	check(absf(total - 1_000_000.0) < 10.0, "sum of float32 0.1s is %f, not 1000000" % total)
+	var mean := nd.mean(a).to_float()
+	check(absf(mean - 0.1) < 1e-6, "mean of float32 0.1s is %f, not 0.1" % mean)
+
+	var rows := nd.sum(nd.full([4, 1_000_000], 0.1, nd.DType.Float32), 1)
+	check(same_values(rows, [100_000.0, 100_000.0, 100_000.0, 100_000.0]), "row sums of float32 0.1s are %s" % rows)
+
+func test_moments_nan() -> void:
+	var moments := nd.moments(nd.array([1.0, NAN, 3.0]))
+	check(is_nan(moments["min"].to_float()), "min with NaN is not NaN")
+	check(is_nan(moments["max"].to_float()), "max with NaN is not NaN")
+	check(is_nan(moments["mean"].to_float()), "mean with NaN is not NaN")
+	check(is_nan(moments["variance"].to_float()), "variance with NaN is not NaN")
+
+	# NaN in a later block, or another thread's part, still reaches the result.
+	var large := nd.arange(1_000_000, null, 1, nd.DType.Float64)
+	large.set(NAN, 700_000)
+	moments = nd.moments(large)
+	check(is_nan(moments["min"].to_float()), "min of a large array with NaN is not NaN")
+	check(is_nan(moments["max"].to_float()), "max of a large array with NaN is not NaN")
+
+	moments = nd.moments(nd.array([2.0, -1.0, 5.0]))
+	check(moments["min"].to_float() == -1.0, "min is %s, not -1" % moments["min"])
+	check(moments["max"].to_float() == 5.0, "max is %s, not 5" % moments["max"])
+
+func test_argmax_ties() -> void:
+	check(nd.argmax(nd.array([1, 3, 3, 2])).to_int() == 1, "argmax of ties isn't the first index")
+	check(nd.argmin(nd.array([2, 0, 1, 0])).to_int() == 1, "argmin of ties isn't the first index")
+	check(nd.argmax(nd.array([1.0, NAN, 5.0, NAN])).to_int() == 1, "argmax isn't the first NaN")
+
+	var large := nd.zeros(1_000_000)
+	large.set(1.0, 123_456)
+	large.set(1.0, 654_321)
+	check(nd.argmax(large).to_int() == 123_456, "argmax of ties in a large array isn't the first index")
+
+func test_top_k_order() -> void:
+	var indices := nd.top_k(nd.array([3, 1, 4, 1, 5, 9, 2, 6]), 3)
+	check(same_values(indices, [5, 7, 4]), "top_k is %s, not [5, 7, 4]" % indices)
+
+	indices = nd.top_k(nd.array([2, 5, 5, 1]), 2)
+	check(same_values(indices, [1, 2]), "top_k of ties is %s, not in order of appearance" % indices)
+
+	indices = nd.top_k(nd.array([1.0, NAN, 3.0]), 2)
+	check(same_values(indices, [1, 2]), "top_k with NaN is %s, not NaN first" % indices)
+
+	indices = nd.top_k(nd.array([[1, 3, 2], [6, 5, 4]]), 2, -1)
+	check(same_values(indices, [1, 2, 0, 1]), "top_k along rows is %s" % indices)
+
+func test_moving_non_finite() -> void:
+	var a := nd.array([1.0, 2.0, NAN, 4.0, 5.0, 6.0])
+	check(same_values(nd.moving_sum(a, 2), [3.0, NAN, NAN, 9.0, 11.0]), "moving_sum after NaN is %s" % nd.moving_sum(a, 2))
+	check(same_values(nd.moving_mean(a, 2), [1.5, NAN, NAN, 4.5, 5.5]), "moving_mean after NaN is %s" % nd.moving_mean(a, 2))
+	check(same_values(nd.moving_max(a, 2), [2.0, NAN, NAN, 5.0, 6.0]), "moving_max after NaN is %s" % nd.moving_max(a, 2))
+	check(same_values(nd.moving_min(a, 2), [1.0, NAN, NAN, 4.0, 5.0]), "moving_min after NaN is %s" % nd.moving_min(a, 2))
+
+	a = nd.array([1.0, INF, 1.0, -INF, 1.0, 1.0])
+	check(same_values(nd.moving_sum(a, 2), [INF, INF, -INF, -INF, 2.0]), "moving_sum with inf is %s" % nd.moving_sum(a, 2))
+	check(same_values(nd.moving_sum(a, 4), [NAN, NAN, -INF]), "moving_sum with inf and -inf is %s" % nd.moving_sum(a, 4))
+
+	# A large value must not wipe out the small ones after it leaves the window.
+	a = nd.array([1e20, 1.0, -1e20, 1.0, 1.0])
+	check(same_values(nd.moving_sum(a, 2), [1e20, -1e20, -1e20, 2.0]), "moving_sum after large values is %s" % nd.moving_sum(a, 2))
+
+func test_histogram_ranges() -> void:
+	var a := nd.array([0.0, 1.0, 2.0, 3.0, 4.0])
+	check(same_values(nd.histogram(a, 4), [1, 1, 1, 2]), "the last bin doesn't include the maximum")
+	check(same_values(nd.histogram(a, 2, [1, 3]), [1, 2]), "values outside the range are counted")
+	check(same_values(nd.histogram(nd.array([NAN, 1.0, 2.0]), 1), [2]), "NaN is counted")
+	check(same_values(nd.histogram(nd.array([5.0, 5.0]), 2), [0, 2]), "a single value isn't centered in the range")
+	check(same_values(nd.histogram(nd.zeros([0]), 2), [0, 0]), "an empty array has counts")
+
+	# These print errors, and return null.
+	check(nd.histogram(nd.array([NAN, NAN]), 2) == null, "an all NaN array has an autodetected range")
+	check(nd.histogram(nd.array([1.0, INF]), 2) == null, "an array with inf has an autodetected range")
+	check(nd.histogram(a, 2, [0, INF]) == null, "an infinite range is accepted")
+	check(nd.histogram(a, 2, [3, 1]) == null, "a decreasing range is accepted")
@@ -4,6 +4,7 @@
 #include <cmath>                                       // for double_t, float_t
 #include <cstddef>                                     // for size_t
 #include <cstdint>                                     // for int32_t, int64_t
+#include <functional>                                  // for cref
 #include <memory>                                      // for allocator, sha...
 #include <stdexcept>                                   // for runtime_error
 #include <tuple>                                       // for tuple
@@ -41,8 +42,8 @@ va::VArray packed_as_xarray(const T shape_array) {
 
     xt::static_shape<std::size_t, 1> shape_of_shape = { size };
 
-    auto store = std::make_shared<xt::xarray<C>>(
-        xt::xarray<C>(xt::adapt(shape_array.ptr(), size, xt::no_ownership(), shape_of_shape))
+    auto store = va::make_store<C>(
+        xt::adapt(shape_array.ptr(), size, xt::no_ownership(), shape_of_shape)
     );
 
     return va::from_store(store);
@@ -322,13 +323,13 @@ va::VArray variant_as_array(const Variant& array) {
             return array_as_varray(array);
         }
         case Variant::BOOL: {
-            return va::from_store(std::make_shared<xt::xarray<bool>>(xt::xarray<bool>(array)));
+            return va::from_store(va::make_store<bool>(static_cast<bool>(array)));
         }
         case Variant::INT: {
-            return va::from_store(std::make_shared<xt::xarray<int64_t>>(xt::xarray<int64_t>(array)));
+            return va::from_store(va::make_store<int64_t>(static_cast<int64_t>(array)));
         }
         case Variant::FLOAT: {
-            return va::from_store(std::make_shared<xt::xarray<double_t>>(xt::xarray<double_t>(array)));
+            return va::from_store(va::make_store<double_t>(static_cast<double_t>(array)));
         }
         case Variant::PACKED_BYTE_ARRAY:
             return packed_as_xarray<uint8_t>(PackedByteArray(array));
@@ -342,37 +343,37 @@ va::VArray variant_as_array(const Variant& array) {
             return packed_as_xarray<double_t>(PackedFloat64Array(array));
         case Variant::VECTOR2I: {
             auto vector = Vector2i(array);
-            return va::from_store(std::make_shared<xt::xarray<int32_t>>(xt::xarray<int32_t>(
+            return va::from_store(va::make_store<int32_t>(va::array_case<int32_t>(
                 { vector.x, vector.y }
             )));
         }
         case Variant::VECTOR3I: {
             auto vector = Vector3i(array);
-            return va::from_store(std::make_shared<xt::xarray<int32_t>>(xt::xarray<int32_t>(
+            return va::from_store(va::make_store<int32_t>(va::array_case<int32_t>(
                 { vector.x, vector.y, vector.z }
             )));
         }
         case Variant::VECTOR4I: {
             auto vector = Vector4i(array);
-            return va::from_store(std::make_shared<xt::xarray<int32_t>>(xt::xarray<int32_t>(
+            return va::from_store(va::make_store<int32_t>(va::array_case<int32_t>(
                 { vector.x, vector.y, vector.z, vector.w }
             )));
         }
         case Variant::VECTOR2: {
             auto vector = Vector2(array);
-            return va::from_store(std::make_shared<xt::xarray<real_t>>(xt::xarray<real_t>(
+            return va::from_store(va::make_store<real_t>(va::array_case<real_t>(
                 { vector.x, vector.y }
             )));
         }
         case Variant::VECTOR3: {
             auto vector = Vector3(array);
-            return va::from_store(std::make_shared<xt::xarray<real_t>>(xt::xarray<real_t>(
+            return va::from_store(va::make_store<real_t>(va::array_case<real_t>(
                 { vector.x, vector.y, vector.z }
             )));
         }
         case Variant::VECTOR4: {
             auto vector = Vector4(array);
-            return va::from_store(std::make_shared<xt::xarray<real_t>>(xt::xarray<real_t>(
+            return va::from_store(va::make_store<real_t>(va::array_case<real_t>(
                 { vector.x, vector.y, vector.z, vector.w }
             )));
         }
@@ -402,3 +403,37 @@ Array varray_to_godot_array(const va::VArray& array) {
     return godot_array;
 #endif
 }
+
+va::VData variant_as_data(const Variant& data) {
+    switch (data.get_type()) {
+        case Variant::BOOL:
+            return va::VConstant(static_cast<bool>(data));
+        case Variant::INT:
+            return va::VConstant(static_cast<int64_t>(data));
+        case Variant::FLOAT:
+            return va::VConstant(static_cast<double_t>(data));
+        default:
+            return variant_as_array(data);
+    }
+}
+
+va::VDataRef variant_as_data_ref(const Variant& data, std::optional<va::VArray>& storage) {
+    switch (data.get_type()) {
+        case Variant::BOOL:
+            return va::VConstant(static_cast<bool>(data));
+        case Variant::INT:
+            return va::VConstant(static_cast<int64_t>(data));
+        case Variant::FLOAT:
+            return va::VConstant(static_cast<double_t>(data));
+        case Variant::OBJECT:
+            if (const auto ndarray = Object::cast_to<NDArray>(data)) {
+                return std::cref(ndarray->array);
+            }
+            break;
+        default:
+            break;
+    }
+
+    storage = variant_as_array(data);
+    return std::cref(*storage);
+}
@@ -3,6 +3,7 @@
 
 #include "vatensor/auto_defines.h"
 #include <godot_cpp/variant/variant.hpp>  // for Variant
+#include <optional>                       // for optional
 #include <variant>                        // for visit
 #include "godot_cpp/variant/array.hpp"    // for Array
 #include "vatensor/varray.h"              // for VArray
@@ -10,6 +11,11 @@
 using namespace godot;
 
 va::VArray variant_as_array(const Variant& array);
+// Like variant_as_array, but returns scalars as constants.
+va::VData variant_as_data(const Variant& data);
+// Like variant_as_data, but references the array of an NDArray instead of copying it.
+// Other arrays are converted into storage, which needs to outlive the result.
+va::VDataRef variant_as_data_ref(const Variant& data, std::optional<va::VArray>& storage);
 
 template <typename P, typename A>
 P packed_from_sequence(A& a) {
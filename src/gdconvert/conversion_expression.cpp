@@ -0,0 +1,43 @@
+#include "conversion_expression.h"
+
+#include <stdexcept>                         // for runtime_error
+#include <string>                            // for string
+#include <vector>                            // for vector
+#include "conversion_array.h"                // for variant_as_data
+#include "godot_cpp/core/object.hpp"         // for Object::cast_to
+#include "godot_cpp/variant/string_name.hpp" // for StringName
+#include "ndexpression.h"                    // for NDExpression
+#include "vatensor/vparse.h"                 // for compile_expression
+
+va::VExpressionPtr variant_as_expression(const Variant& variant) {
+    if (variant.get_type() == Variant::OBJECT) {
+        if (const auto ndexpression = Object::cast_to<NDExpression>(variant)) {
+            if (ndexpression->expression == nullptr) {
+                throw std::runtime_error("The expression is empty.");
+            }
+            return ndexpression->expression;
+        }
+    }
+
+    return va::make_leaf(variant_as_data(variant));
+}
+
+va::VExpressionPtr string_as_expression(const String& source, const Dictionary& variables) {
+    const auto compiled = va::compile_expression(source.utf8().get_data());
+
+    std::vector<va::VData> values;
+    values.reserve(compiled->variables.size());
+    for (const auto& name : compiled->variables) {
+        // Keys may be Strings, or StringNames when written like {a=...}.
+        const String key = String::utf8(name.c_str());
+        if (variables.has(key)) {
+            values.push_back(variant_as_data(variables[key]));
+        } else if (variables.has(StringName(key))) {
+            values.push_back(variant_as_data(variables[StringName(key)]));
+        } else {
+            throw std::runtime_error("Missing value for variable '" + name + "'.");
+        }
+    }
+
+    return compiled->bind(values);
+}
@@ -0,0 +1,17 @@
+#ifndef CONVERSION_EXPRESSION_H
+#define CONVERSION_EXPRESSION_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include "vatensor/vexpression.h"
+
+using namespace godot;
+
+// NDExpressions are used as they are; everything else becomes a leaf.
+va::VExpressionPtr variant_as_expression(const Variant& variant);
+
+// Compiles the source (see va::compile_expression), with the variables' values taken from the dictionary.
+va::VExpressionPtr string_as_expression(const String& source, const Dictionary& variables);
+
+#endif //CONVERSION_EXPRESSION_H
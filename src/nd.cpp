@@ -1,35 +1,46 @@
 #include "nd.h"
 
 #include <vatensor/comparison.h>            // for equal_to, greater, greate...
+#include <vatensor/histogram.h>             // for bincount, histogram
 #include <vatensor/logical.h>               // for logical_and, logical_not
-#include <vatensor/reduce.h>                // for max, mean, min, prod, std
+#include <vatensor/reduce.h>                // for max, mean, min, moments, prod, std, top_k
 #include <vatensor/round.h>                 // for ceil, floor, nearbyint
+#include <vatensor/scan.h>                  // for cummax, cumprod, cumsum
 #include <vatensor/trigonometry.h>          // for acos, acosh, asin, asinh
+#include <vatensor/window.h>                // for moving_max, moving_mean, moving_min, moving_sum
 #include <vatensor/vmath.h>                 // for abs, add, deg2rad, divide
+#include <array>                            // for array
 #include <cmath>                            // for double_t
 #include <cstddef>                          // for ptrdiff_t, size_t
 #include <functional>                       // for function
-#include <memory>                           // for make_shared
 #include <optional>                         // for optional
 #include <stdexcept>                        // for runtime_error
+#include <tuple>                            // for tuple, apply
 #include <type_traits>                      // for decay_t
-#include <utility>                          // for move
+#include <utility>                          // for move, pair
 #include <variant>                          // for visit, variant
 #include <vector>                           // for vector
 #include <vatensor/linalg.h>
 #include "gdconvert/conversion_array.h"     // for variant_as_array
 #include "gdconvert/conversion_axes.h"      // for variant_to_axes
+#include "gdconvert/conversion_expression.h" // for string_as_expression
 #include "gdconvert/conversion_range.h"     // for to_range_part
 #include "gdconvert/conversion_shape.h"     // for variant_as_shape
 #include "gdconvert/conversion_slice.h"     // for ellipsis, newaxis
 #include "godot_cpp/classes/ref.hpp"        // for Ref
 #include "godot_cpp/core/error_macros.hpp"  // for ERR_FAIL_V_MSG
 #include "godot_cpp/core/memory.hpp"        // for _post_initialize, memnew
+#include "godot_cpp/variant/array.hpp"      // for Array
+#include "godot_cpp/variant/vector2.hpp"    // for Vector2
+#include "godot_cpp/variant/vector2i.hpp"   // for Vector2i
 #include "ndarray.h"                        // for NDArray
 #include "ndrange.h"                        // for NDRange
 #include "vatensor/allocate.h"              // for empty, full, copy_as_dtype
 #include "vatensor/rearrange.h"             // for reshape, transpose, flip
 #include "vatensor/varray.h"                // for VArrayTarget, DType, VArray
+#include "vatensor/vexpression.h"           // for evaluate
+#include "vatensor/vparallel.h"             // for set_num_threads, set_threshold
+#include "vatensor/vpool.h"                 // for set_max_retained_bytes
 #include "xtensor/xbuilder.hpp"             // for arange, linspace
 #include "xtensor/xlayout.hpp"              // for layout_type
 #include "xtensor/xslice.hpp"               // for xtuph
@@ -62,6 +73,13 @@ void nd::_bind_methods() {
 
 	godot::ClassDB::bind_static_method("nd", D_METHOD("size_of_dtype_in_bytes", "dtype"), &nd::size_of_dtype_in_bytes);
 
+	godot::ClassDB::bind_static_method("nd", D_METHOD("set_memory_pool_limit", "max_bytes"), &nd::set_memory_pool_limit);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_memory_pool_limit"), &nd::get_memory_pool_limit);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("set_num_threads", "num_threads"), &nd::set_num_threads);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_num_threads"), &nd::get_num_threads);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("set_parallel_threshold", "num_elements"), &nd::set_parallel_threshold);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("get_parallel_threshold"), &nd::get_parallel_threshold);
+
 	godot::ClassDB::bind_static_method("nd", D_METHOD("as_array", "array", "dtype"), &nd::as_array, DEFVAL(nullptr), DEFVAL(nd::DType::DTypeMax));
 	godot::ClassDB::bind_static_method("nd", D_METHOD("array", "array", "dtype"), &nd::array, DEFVAL(nullptr), DEFVAL(nd::DType::DTypeMax));
 
@@ -80,81 +98,100 @@ void nd::_bind_methods() {
 	godot::ClassDB::bind_static_method("nd", D_METHOD("stack", "v", "axis"), &nd::stack, DEFVAL(nullptr), 0);
 	godot::ClassDB::bind_static_method("nd", D_METHOD("unstack", "v", "axis"), &nd::unstack, DEFVAL(nullptr), 0);
 
-	godot::ClassDB::bind_static_method("nd", D_METHOD("add", "a", "b"), &nd::add);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("subtract", "a", "b"), &nd::subtract);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("multiply", "a", "b"), &nd::multiply);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("divide", "a", "b"), &nd::divide);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("remainder", "a", "b"), &nd::remainder);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("pow", "a", "b"), &nd::pow);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("minimum", "a", "b"), &nd::minimum);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("maximum", "a", "b"), &nd::maximum);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("clip", "a", "min", "max"), &nd::clip);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("sign", "a"), &nd::sign);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("abs", "a"), &nd::abs);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("square", "a"), &nd::square);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("sqrt", "a"), &nd::sqrt);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("exp", "a"), &nd::exp);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("log", "a"), &nd::log);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("rad2deg", "a"), &nd::rad2deg);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("deg2rad", "a"), &nd::deg2rad);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("sin", "a"), &nd::sin);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("cos", "a"), &nd::cos);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("tan", "a"), &nd::tan);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("asin", "a"), &nd::asin);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("acos", "a"), &nd::acos);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("atan", "a"), &nd::atan);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("atan2", "x1", "x2"), &nd::atan2);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("sinh", "a"), &nd::sinh);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("cosh", "a"), &nd::cosh);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("tanh", "a"), &nd::tanh);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("asinh", "a"), &nd::asinh);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("acosh", "a"), &nd::acosh);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("atanh", "a"), &nd::atanh);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("sum", "a", "axes"), &nd::sum, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("prod", "a", "axes"), &nd::prod, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("mean", "a", "axes"), &nd::mean, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("var", "a", "axes"), &nd::var, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("std", "a", "axes"), &nd::std, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("max", "a", "axes"), &nd::max, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("min", "a", "axes"), &nd::min, DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("norm", "a", "ord", "axes"), &nd::norm, DEFVAL(nullptr), DEFVAL(2), DEFVAL(nullptr));
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("floor", "a"), &nd::floor);
-    godot::ClassDB::bind_static_method("nd", D_METHOD("ceil", "a"), &nd::ceil);
-    godot::ClassDB::bind_static_method("nd", D_METHOD("round", "a"), &nd::round);
-    godot::ClassDB::bind_static_method("nd", D_METHOD("trunc", "a"), &nd::trunc);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("rint", "a"), &nd::rint);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("equal", "a", "b"), &nd::equal);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("not_equal", "a", "b"), &nd::not_equal);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("greater", "a", "b"), &nd::greater);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("greater_equal", "a", "b"), &nd::greater_equal);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("less", "a", "b"), &nd::less);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("less_equal", "a", "b"), &nd::less_equal);
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_and", "a", "b"), &nd::logical_and);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_or", "a", "b"), &nd::logical_or);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_not", "a"), &nd::logical_not);
-    godot::ClassDB::bind_static_method("nd", D_METHOD("all", "a", "axes"), &nd::all, DEFVAL(nullptr), DEFVAL(nullptr));
-    godot::ClassDB::bind_static_method("nd", D_METHOD("any", "a", "axes"), &nd::any, DEFVAL(nullptr), DEFVAL(nullptr));
-
-	godot::ClassDB::bind_static_method("nd", D_METHOD("dot", "a", "b"), &nd::dot);
-	godot::ClassDB::bind_static_method("nd", D_METHOD("reduce_dot", "a", "b", "axes"), &nd::reduce_dot, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
-	godot::ClassDB::bind_static_method("nd", D_METHOD("matmul", "a", "b"), &nd::matmul);
+	godot::ClassDB::bind_static_method("nd", D_METHOD("add", "a", "b", "out"), &nd::add, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("subtract", "a", "b", "out"), &nd::subtract, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("multiply", "a", "b", "out"), &nd::multiply, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("divide", "a", "b", "out"), &nd::divide, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("remainder", "a", "b", "out"), &nd::remainder, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("pow", "a", "b", "out"), &nd::pow, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("minimum", "a", "b", "out"), &nd::minimum, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("maximum", "a", "b", "out"), &nd::maximum, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("clip", "a", "min", "max", "out"), &nd::clip, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sign", "a", "out"), &nd::sign, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("abs", "a", "out"), &nd::abs, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("square", "a", "out"), &nd::square, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sqrt", "a", "out"), &nd::sqrt, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("exp", "a", "out"), &nd::exp, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("log", "a", "out"), &nd::log, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rad2deg", "a", "out"), &nd::rad2deg, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("deg2rad", "a", "out"), &nd::deg2rad, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sin", "a", "out"), &nd::sin, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cos", "a", "out"), &nd::cos, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("tan", "a", "out"), &nd::tan, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("asin", "a", "out"), &nd::asin, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("acos", "a", "out"), &nd::acos, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("atan", "a", "out"), &nd::atan, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("atan2", "x1", "x2", "out"), &nd::atan2, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sinh", "a", "out"), &nd::sinh, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cosh", "a", "out"), &nd::cosh, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("tanh", "a", "out"), &nd::tanh, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("asinh", "a", "out"), &nd::asinh, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("acosh", "a", "out"), &nd::acosh, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("atanh", "a", "out"), &nd::atanh, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("sum", "a", "axes", "out"), &nd::sum, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("prod", "a", "axes", "out"), &nd::prod, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("mean", "a", "axes", "out"), &nd::mean, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("var", "a", "axes", "out"), &nd::var, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("std", "a", "axes", "out"), &nd::std, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("max", "a", "axes", "out"), &nd::max, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("min", "a", "axes", "out"), &nd::min, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("moments", "a", "axes"), &nd::moments, DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("argmax", "a", "axes", "out"), &nd::argmax, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("argmin", "a", "axes", "out"), &nd::argmin, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("top_k", "a", "k", "axis", "out"), &nd::top_k, DEFVAL(nullptr), DEFVAL(1), DEFVAL(-1), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("norm", "a", "ord", "axes", "out"), &nd::norm, DEFVAL(nullptr), DEFVAL(2), DEFVAL(nullptr), DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cumsum", "a", "axis", "out"), &nd::cumsum, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cumprod", "a", "axis", "out"), &nd::cumprod, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("cummax", "a", "axis", "out"), &nd::cummax, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("bincount", "a", "weights", "min_length", "out"), &nd::bincount, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(0), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("histogram", "a", "bins", "range", "out"), &nd::histogram, DEFVAL(nullptr), DEFVAL(10), DEFVAL(nullptr), DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("moving_sum", "a", "window", "axis", "out"), &nd::moving_sum, DEFVAL(nullptr), DEFVAL(1), DEFVAL(-1), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("moving_mean", "a", "window", "axis", "out"), &nd::moving_mean, DEFVAL(nullptr), DEFVAL(1), DEFVAL(-1), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("moving_min", "a", "window", "axis", "out"), &nd::moving_min, DEFVAL(nullptr), DEFVAL(1), DEFVAL(-1), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("moving_max", "a", "window", "axis", "out"), &nd::moving_max, DEFVAL(nullptr), DEFVAL(1), DEFVAL(-1), DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("floor", "a", "out"), &nd::floor, DEFVAL(nullptr));
+    godot::ClassDB::bind_static_method("nd", D_METHOD("ceil", "a", "out"), &nd::ceil, DEFVAL(nullptr));
+    godot::ClassDB::bind_static_method("nd", D_METHOD("round", "a", "out"), &nd::round, DEFVAL(nullptr));
+    godot::ClassDB::bind_static_method("nd", D_METHOD("trunc", "a", "out"), &nd::trunc, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("rint", "a", "out"), &nd::rint, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("equal", "a", "b", "out"), &nd::equal, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("not_equal", "a", "b", "out"), &nd::not_equal, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("greater", "a", "b", "out"), &nd::greater, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("greater_equal", "a", "b", "out"), &nd::greater_equal, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("less", "a", "b", "out"), &nd::less, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("less_equal", "a", "b", "out"), &nd::less_equal, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_and", "a", "b", "out"), &nd::logical_and, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_or", "a", "b", "out"), &nd::logical_or, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_xor", "a", "b", "out"), &nd::logical_xor, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("logical_not", "a", "out"), &nd::logical_not, DEFVAL(nullptr));
+    godot::ClassDB::bind_static_method("nd", D_METHOD("all", "a", "axes", "out"), &nd::all, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+    godot::ClassDB::bind_static_method("nd", D_METHOD("any", "a", "axes", "out"), &nd::any, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("dot", "a", "b", "out"), &nd::dot, DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("reduce_dot", "a", "b", "axes", "out"), &nd::reduce_dot, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
+	godot::ClassDB::bind_static_method("nd", D_METHOD("matmul", "a", "b", "out"), &nd::matmul, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_static_method("nd", D_METHOD("evaluate", "expression", "variables"), &nd::evaluate, DEFVAL(Dictionary()));
 }
 
 nd::nd() = default;
 nd::~nd() = default;
 
 template <typename Visitor, typename... Args>
-Ref<NDArray> map_variants_as_arrays(Visitor visitor, Args... args) {
+Ref<NDArray> map_variants_as_arrays(Visitor visitor, const Args&... args) {
 	try {
 		const auto result = visitor(variant_as_array(args)...);
 		return { memnew(NDArray(result)) };
@@ -164,52 +201,96 @@ Ref<NDArray> map_variants_as_arrays(Visitor visitor, Args... args) {
 	}
 }
 
+// Calls the visitor with out as the target if given, or with a new array otherwise.
+// Either way, returns the array that holds the result.
+template <typename Visitor>
+Ref<NDArray> visit_with_target(const Ref<NDArray>& out, Visitor visitor) {
+	if (out.is_valid()) {
+		visitor(&out->array.compute_variant_for_write());
+		return out;
+	}
+
+	std::optional<va::VArray> result;
+	visitor(&result);
+	return { memnew(NDArray(std::move(*result))) };
+}
+
 template <typename Visitor, typename... Args>
-Ref<NDArray> map_variants_as_arrays_with_target(Visitor visitor, Args... args) {
+Ref<NDArray> map_variants_as_arrays_with_target(Visitor visitor, const Ref<NDArray>& out, const Args&... args) {
 	try {
-		std::optional<va::VArray> result;
-		visitor(&result, variant_as_array(args)...);
-		return { memnew(NDArray(result.value())) };
+		return visit_with_target(out, [&](const va::VArrayTarget target) {
+			visitor(target, variant_as_array(args)...);
+		});
 	}
 	catch (std::runtime_error& error) {
 		ERR_FAIL_V_MSG({}, error.what());
 	}
 }
 
+// Like map_variants_as_arrays_with_target, but passes scalars as constants rather than 0-d arrays.
 template <typename Visitor, typename... Args>
-inline Ref<NDArray> reduction(Visitor visitor, Variant axes, Args... args) {
+Ref<NDArray> map_variants_as_data_with_target(Visitor visitor, const Ref<NDArray>& out, const Args&... args) {
 	try {
-		const auto axes_ = variant_to_axes(axes);
+		return visit_with_target(out, [&](const va::VArrayTarget target) {
+			std::array<std::optional<va::VArray>, sizeof...(Args)> storage;
+			std::size_t storage_index = 0;
+			const std::tuple data { variant_as_data_ref(args, storage[storage_index++])... };
+
+			std::apply([&](const auto&... data) {
+				visitor(target, data...);
+			}, data);
+		});
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
 
-		std::optional<va::VArray> result;
-		visitor(&result, axes_, variant_as_array(args)...);
+template <typename Visitor, typename... Args>
+inline Ref<NDArray> reduction(Visitor visitor, const Ref<NDArray>& out, const Variant& axes, const Args&... args) {
+	try {
+		const auto axes_ = variant_to_axes(axes);
 
-		return {memnew(NDArray(result.value()))};
+		return visit_with_target(out, [&](const va::VArrayTarget target) {
+			visitor(target, axes_, variant_as_array(args)...);
+		});
 	}
 	catch (std::runtime_error& error) {
 		ERR_FAIL_V_MSG({}, error.what());
 	}
 }
 
-#define UNARY_MAP(func, varray1) \
+// For functions over windows of consecutive elements along one axis, like va::moving_sum.
+template <typename Function>
+Ref<NDArray> window_reduction(Function function, const Ref<NDArray>& out, const Variant& a, const int64_t window, const int64_t axis) {
+	if (window <= 0) {
+		ERR_FAIL_V_MSG({}, "The window must be positive.");
+	}
+
+	return map_variants_as_arrays_with_target([function, window, axis](const va::VArrayTarget target, const va::VArray& array) {
+		function(target, array, static_cast<std::size_t>(window), static_cast<std::ptrdiff_t>(axis));
+	}, out, a);
+}
+
+#define UNARY_MAP(func, varray1, out) \
 	map_variants_as_arrays_with_target([](const va::VArrayTarget target, const va::VArray& varray) {\
         va::func(target, varray);\
-    }, (varray1))
+    }, (out), (varray1))
 
-#define BINARY_MAP(func, varray1, varray2) \
-	map_variants_as_arrays_with_target([](const va::VArrayTarget target, const va::VArray& a, const va::VArray& b) {\
+#define BINARY_MAP(func, varray1, varray2, out) \
+	map_variants_as_data_with_target([](const va::VArrayTarget target, const va::VDataRef& a, const va::VDataRef& b) {\
         va::func(target, a, b);\
-    }, (varray1), (varray2))
+    }, (out), (varray1), (varray2))
 
-#define TERNARY_MAP(func, varray1, varray2, varray3) \
+#define TERNARY_MAP(func, varray1, varray2, varray3, out) \
 	map_variants_as_arrays_with_target([](const va::VArrayTarget target, const va::VArray& a, const va::VArray& b, const va::VArray& c) {\
         va::func(target, a, b, c);\
-    }, (varray1), (varray2), (varray3))
+    }, (out), (varray1), (varray2), (varray3))
 
-#define REDUCTION(func, varray1, axes1) \
+#define REDUCTION(func, varray1, axes1, out) \
 	reduction([](const va::VArrayTarget target, const va::Axes& axes, const va::VArray& array) {\
 		va::func(target, array, axes);\
-	}, axes, (varray1))
+	}, (out), (axes1), (varray1))
 
 StringName nd::newaxis() {
 	return ::newaxis();
@@ -256,6 +337,33 @@ uint64_t nd::size_of_dtype_in_bytes(DType dtype) {
 	return va::size_of_dtype_in_bytes(dtype);
 }
 
+void nd::set_memory_pool_limit(int64_t max_bytes) {
+	ERR_FAIL_COND_MSG(max_bytes < 0, "The memory pool limit must not be negative.");
+	va::pool::set_max_retained_bytes(static_cast<std::size_t>(max_bytes));
+}
+
+int64_t nd::get_memory_pool_limit() {
+	return static_cast<int64_t>(va::pool::get_max_retained_bytes());
+}
+
+void nd::set_num_threads(int64_t num_threads) {
+	ERR_FAIL_COND_MSG(num_threads < 0, "The number of threads must not be negative.");
+	va::parallel::set_num_threads(static_cast<std::size_t>(num_threads));
+}
+
+int64_t nd::get_num_threads() {
+	return static_cast<int64_t>(va::parallel::get_num_threads());
+}
+
+void nd::set_parallel_threshold(int64_t num_elements) {
+	ERR_FAIL_COND_MSG(num_elements < 0, "The parallel threshold must not be negative.");
+	va::parallel::set_threshold(static_cast<std::size_t>(num_elements));
+}
+
+int64_t nd::get_parallel_threshold() {
+	return static_cast<int64_t>(va::parallel::get_threshold());
+}
+
 Ref<NDArray> nd::as_array(Variant array, nd::DType dtype) {
 	auto type = array.get_type();
 
@@ -347,11 +455,11 @@ Ref<NDArray> nd::linspace(Variant start, Variant stop, int64_t num, bool endpoin
 			using T = std::decay_t<decltype(t)>;
 
 			if constexpr (std::is_floating_point_v<T>) {
-				auto store = std::make_shared<xt::xarray<T>>(xt::linspace(static_cast<double_t>(start), static_cast<double_t>(stop), num, endpoint));
+				auto store = va::make_store<T>(xt::linspace(static_cast<double_t>(start), static_cast<double_t>(stop), num, endpoint));
 				return va::from_store(store);
 			}
 			else {
-				auto store = std::make_shared<xt::xarray<T>>(xt::linspace(static_cast<int64_t>(start), static_cast<int64_t>(stop), num, endpoint));
+				auto store = va::make_store<T>(xt::linspace(static_cast<int64_t>(start), static_cast<int64_t>(stop), num, endpoint));
 				return va::from_store(store);
 			}
 		}, va::dtype_to_variant(dtype));
@@ -384,11 +492,11 @@ Ref<NDArray> nd::arange(Variant start_or_stop, Variant stop, Variant step, DType
 			using T = std::decay_t<decltype(t)>;
 
 			if constexpr (std::is_floating_point_v<T>) {
-				auto store = std::make_shared<xt::xarray<T>>(xt::arange(static_cast<double_t>(start_or_stop), static_cast<double_t>(stop), static_cast<double_t>(step)));
+				auto store = va::make_store<T>(xt::arange(static_cast<double_t>(start_or_stop), static_cast<double_t>(stop), static_cast<double_t>(step)));
 				return va::from_store(store);
 			}
 			else {
-				auto store = std::make_shared<xt::xarray<T>>(xt::arange(static_cast<int64_t>(start_or_stop), static_cast<int64_t>(stop), static_cast<int64_t>(step)));
+				auto store = va::make_store<T>(xt::arange(static_cast<int64_t>(start_or_stop), static_cast<int64_t>(stop), static_cast<int64_t>(step)));
 				return va::from_store(store);
 			}
 		}, va::dtype_to_variant(dtype));
@@ -452,170 +560,205 @@ Ref<NDArray> nd::unstack(Variant v, int64_t axis) {
 	}, v);
 }
 
-Ref<NDArray> nd::add(Variant a, Variant b) {
-	return BINARY_MAP(add, a, b);
+Ref<NDArray> nd::add(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(add, a, b, out);
+}
+
+Ref<NDArray> nd::subtract(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(subtract, a, b, out);
+}
+
+Ref<NDArray> nd::multiply(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(multiply, a, b, out);
+}
+
+Ref<NDArray> nd::divide(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(divide, a, b, out);
+}
+
+Ref<NDArray> nd::remainder(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(remainder, a, b, out);
 }
 
-Ref<NDArray> nd::subtract(Variant a, Variant b) {
-	return BINARY_MAP(subtract, a, b);
+Ref<NDArray> nd::pow(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(pow, a, b, out);
 }
 
-Ref<NDArray> nd::multiply(Variant a, Variant b) {
-	return BINARY_MAP(multiply, a, b);
+Ref<NDArray> nd::minimum(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(minimum, a, b, out);
 }
 
-Ref<NDArray> nd::divide(Variant a, Variant b) {
-	return BINARY_MAP(divide, a, b);
+Ref<NDArray> nd::maximum(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(maximum, a, b, out);
 }
 
-Ref<NDArray> nd::remainder(Variant a, Variant b) {
-	return BINARY_MAP(remainder, a, b);
+Ref<NDArray> nd::clip(Variant a, Variant min, Variant max, const Ref<NDArray>& out) {
+	return TERNARY_MAP(clip, a, min, max, out);
 }
 
-Ref<NDArray> nd::pow(Variant a, Variant b) {
-	return BINARY_MAP(pow, a, b);
+Ref<NDArray> nd::sign(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(sign, a, out);
 }
 
-Ref<NDArray> nd::minimum(Variant a, Variant b) {
-	return BINARY_MAP(minimum, a, b);
+Ref<NDArray> nd::abs(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(abs, a, out);
 }
 
-Ref<NDArray> nd::maximum(Variant a, Variant b) {
-	return BINARY_MAP(maximum, a, b);
+Ref<NDArray> nd::square(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(square, a, out);
 }
 
-Ref<NDArray> nd::clip(Variant a, Variant min, Variant max) {
-	return TERNARY_MAP(clip, a, min, max);
+Ref<NDArray> nd::sqrt(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(sqrt, a, out);
 }
 
-Ref<NDArray> nd::sign(Variant a) {
-	return UNARY_MAP(sign, a);
+Ref<NDArray> nd::exp(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(exp, a, out);
 }
 
-Ref<NDArray> nd::abs(Variant a) {
-	return UNARY_MAP(abs, a);
+Ref<NDArray> nd::log(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(log, a, out);
 }
 
-Ref<NDArray> nd::square(Variant a) {
-	return UNARY_MAP(square, a);
+Ref<NDArray> nd::rad2deg(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(rad2deg, a, out);
 }
 
-Ref<NDArray> nd::sqrt(Variant a) {
-	return UNARY_MAP(sqrt, a);
+Ref<NDArray> nd::deg2rad(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(deg2rad, a, out);
 }
 
-Ref<NDArray> nd::exp(Variant a) {
-	return UNARY_MAP(exp, a);
+Ref<NDArray> nd::sin(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(sin, a, out);
 }
 
-Ref<NDArray> nd::log(Variant a) {
-	return UNARY_MAP(log, a);
+Ref<NDArray> nd::cos(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(cos, a, out);
 }
 
-Ref<NDArray> nd::rad2deg(Variant a) {
-	return UNARY_MAP(rad2deg, a);
+Ref<NDArray> nd::tan(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(tan, a, out);
 }
 
-Ref<NDArray> nd::deg2rad(Variant a) {
-	return UNARY_MAP(deg2rad, a);
+Ref<NDArray> nd::asin(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(asin, a, out);
 }
 
-Ref<NDArray> nd::sin(Variant a) {
-	return UNARY_MAP(sin, a);
+Ref<NDArray> nd::acos(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(acos, a, out);
 }
 
-Ref<NDArray> nd::cos(Variant a) {
-	return UNARY_MAP(cos, a);
+Ref<NDArray> nd::atan(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(atan, a, out);
 }
 
-Ref<NDArray> nd::tan(Variant a) {
-	return UNARY_MAP(tan, a);
+Ref<NDArray> nd::atan2(Variant x1, Variant x2, const Ref<NDArray>& out) {
+	return BINARY_MAP(atan2, x1, x2, out);
 }
 
-Ref<NDArray> nd::asin(Variant a) {
-	return UNARY_MAP(asin, a);
+Ref<NDArray> nd::sinh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(sinh, a, out);
 }
 
-Ref<NDArray> nd::acos(Variant a) {
-	return UNARY_MAP(acos, a);
+Ref<NDArray> nd::cosh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(cosh, a, out);
 }
 
-Ref<NDArray> nd::atan(Variant a) {
-	return UNARY_MAP(atan, a);
+Ref<NDArray> nd::tanh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(tanh, a, out);
 }
 
-Ref<NDArray> nd::atan2(Variant x1, Variant x2) {
-	return BINARY_MAP(atan2, x1, x2);
+Ref<NDArray> nd::asinh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(asinh, a, out);
 }
 
-Ref<NDArray> nd::sinh(Variant a) {
-	return UNARY_MAP(sinh, a);
+Ref<NDArray> nd::acosh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(acosh, a, out);
 }
 
-Ref<NDArray> nd::cosh(Variant a) {
-	return UNARY_MAP(cosh, a);
+Ref<NDArray> nd::atanh(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(atanh, a, out);
 }
 
-Ref<NDArray> nd::tanh(Variant a) {
-	return UNARY_MAP(tanh, a);
+Ref<NDArray> nd::sum(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(sum, a, axes, out);
 }
 
-Ref<NDArray> nd::asinh(Variant a) {
-	return UNARY_MAP(asinh, a);
+Ref<NDArray> nd::prod(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(prod, a, axes, out);
 }
 
-Ref<NDArray> nd::acosh(Variant a) {
-	return UNARY_MAP(acosh, a);
+Ref<NDArray> nd::mean(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(mean, a, axes, out);
 }
 
-Ref<NDArray> nd::atanh(Variant a) {
-	return UNARY_MAP(atanh, a);
+Ref<NDArray> nd::var(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(var, a, axes, out);
 }
 
-Ref<NDArray> nd::sum(Variant a, Variant axes) {
-	return REDUCTION(sum, a, axes);
+Ref<NDArray> nd::std(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(std, a, axes, out);
 }
 
-Ref<NDArray> nd::prod(Variant a, Variant axes) {
-	return REDUCTION(prod, a, axes);
+Ref<NDArray> nd::max(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(max, a, axes, out);
 }
 
-Ref<NDArray> nd::mean(Variant a, Variant axes) {
-	return REDUCTION(mean, a, axes);
+Ref<NDArray> nd::min(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(min, a, axes, out);
 }
 
-Ref<NDArray> nd::var(Variant a, Variant axes) {
-	return REDUCTION(var, a, axes);
+Dictionary nd::moments(Variant a, Variant axes) {
+	try {
+		const auto moments = va::moments(variant_as_array(a), variant_to_axes(axes));
+
+		Dictionary result;
+		result["count"] = static_cast<int64_t>(moments.count);
+		result["min"] = Ref<NDArray>(memnew(NDArray(moments.min)));
+		result["max"] = Ref<NDArray>(memnew(NDArray(moments.max)));
+		result["mean"] = Ref<NDArray>(memnew(NDArray(moments.mean)));
+		result["variance"] = Ref<NDArray>(memnew(NDArray(moments.variance)));
+		return result;
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
 }
 
-Ref<NDArray> nd::std(Variant a, Variant axes) {
-	return REDUCTION(std, a, axes);
+Ref<NDArray> nd::argmax(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(argmax, a, axes, out);
 }
 
-Ref<NDArray> nd::max(Variant a, Variant axes) {
-	return REDUCTION(max, a, axes);
+Ref<NDArray> nd::argmin(Variant a, Variant axes, const Ref<NDArray>& out) {
+	return REDUCTION(argmin, a, axes, out);
 }
 
-Ref<NDArray> nd::min(Variant a, Variant axes) {
-	return REDUCTION(min, a, axes);
+Ref<NDArray> nd::top_k(Variant a, int64_t k, int64_t axis, const Ref<NDArray>& out) {
+	if (k < 0) {
+		ERR_FAIL_V_MSG({}, "k must not be negative.");
+	}
+
+	return map_variants_as_arrays_with_target([k, axis](const va::VArrayTarget target, const va::VArray& array) {
+		va::top_k(target, array, static_cast<std::size_t>(k), static_cast<std::ptrdiff_t>(axis));
+	}, out, a);
 }
 
-Ref<NDArray> nd::norm(Variant a, Variant ord, Variant axes) {
+Ref<NDArray> nd::norm(Variant a, Variant ord, Variant axes, const Ref<NDArray>& out) {
 	switch (ord.get_type()) {
 		case Variant::INT:
 			switch (static_cast<int64_t>(ord)) {
 				case 0:
-					return REDUCTION(norm_l0, a, axes);
+					return REDUCTION(norm_l0, a, axes, out);
 				case 1:
-					return REDUCTION(norm_l1, a, axes);
+					return REDUCTION(norm_l1, a, axes, out);
 				case 2:
-					return REDUCTION(norm_l2, a, axes);
+					return REDUCTION(norm_l2, a, axes, out);
 				default:
 					break;
 			}
 		case Variant::FLOAT:
 			if (std::isinf(static_cast<double_t>(ord))) {
-				return REDUCTION(norm_linf, a, axes);
+				return REDUCTION(norm_linf, a, axes, out);
 			}
 		default:
 			break;
@@ -624,85 +767,204 @@ Ref<NDArray> nd::norm(Variant a, Variant ord, Variant axes) {
 	ERR_FAIL_V_MSG({}, "This norm is currently not supported");
 }
 
-Ref<NDArray> nd::floor(Variant a) {
-	return UNARY_MAP(floor, a);
+Ref<NDArray> nd::cumsum(Variant a, Variant axis, const Ref<NDArray>& out) {
+	return REDUCTION(cumsum, a, axis, out);
 }
 
-Ref<NDArray> nd::ceil(Variant a) {
-	return UNARY_MAP(ceil, a);
+Ref<NDArray> nd::cumprod(Variant a, Variant axis, const Ref<NDArray>& out) {
+	return REDUCTION(cumprod, a, axis, out);
 }
 
-Ref<NDArray> nd::round(Variant a) {
-	return UNARY_MAP(round, a);
+Ref<NDArray> nd::cummax(Variant a, Variant axis, const Ref<NDArray>& out) {
+	return REDUCTION(cummax, a, axis, out);
 }
 
-Ref<NDArray> nd::trunc(Variant a) {
-	return UNARY_MAP(trunc, a);
+Ref<NDArray> nd::bincount(Variant a, Variant weights, int64_t min_length, const Ref<NDArray>& out) {
+	if (min_length < 0) {
+		ERR_FAIL_V_MSG({}, "min_length must not be negative.");
+	}
+
+	try {
+		const auto array = variant_as_array(a);
+		std::optional<va::VArray> weights_array;
+		if (weights.get_type() != Variant::NIL) {
+			weights_array = variant_as_array(weights);
+		}
+
+		return visit_with_target(out, [&](const va::VArrayTarget target) {
+			va::bincount(target, array, weights_array, static_cast<std::size_t>(min_length));
+		});
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+Ref<NDArray> nd::histogram(Variant a, Variant bins, Variant range, const Ref<NDArray>& out) {
+	std::optional<std::pair<double, double>> range_pair;
+	switch (range.get_type()) {
+		case Variant::NIL:
+			break;
+		case Variant::VECTOR2: {
+			const Vector2 vector = range;
+			range_pair = { vector.x, vector.y };
+			break;
+		}
+		case Variant::VECTOR2I: {
+			const Vector2i vector = range;
+			range_pair = { vector.x, vector.y };
+			break;
+		}
+		case Variant::ARRAY: {
+			const Array array = range;
+			if (array.size() != 2) {
+				ERR_FAIL_V_MSG({}, "The range must have two elements.");
+			}
+			range_pair = { static_cast<double>(array[0]), static_cast<double>(array[1]) };
+			break;
+		}
+		default:
+			ERR_FAIL_V_MSG({}, "The range must be null, a Vector2 or an Array of two numbers.");
+	}
+
+	try {
+		const auto array = variant_as_array(a);
+
+		if (bins.get_type() == Variant::INT) {
+			const int64_t num_bins = bins;
+			if (num_bins <= 0) {
+				ERR_FAIL_V_MSG({}, "The number of bins must be positive.");
+			}
+
+			return visit_with_target(out, [&](const va::VArrayTarget target) {
+				va::histogram(target, array, static_cast<std::size_t>(num_bins), range_pair);
+			});
+		}
+
+		if (range_pair.has_value()) {
+			ERR_FAIL_V_MSG({}, "The range can only be given with a number of bins, not with bin edges.");
+		}
+
+		const auto edges = variant_as_array(bins);
+		return visit_with_target(out, [&](const va::VArrayTarget target) {
+			va::histogram(target, array, edges);
+		});
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+Ref<NDArray> nd::moving_sum(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out) {
+	return window_reduction(&va::moving_sum, out, a, window, axis);
+}
+
+Ref<NDArray> nd::moving_mean(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out) {
+	return window_reduction(&va::moving_mean, out, a, window, axis);
+}
+
+Ref<NDArray> nd::moving_min(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out) {
+	return window_reduction(&va::moving_min, out, a, window, axis);
+}
+
+Ref<NDArray> nd::moving_max(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out) {
+	return window_reduction(&va::moving_max, out, a, window, axis);
+}
+
+Ref<NDArray> nd::floor(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(floor, a, out);
+}
+
+Ref<NDArray> nd::ceil(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(ceil, a, out);
+}
+
+Ref<NDArray> nd::round(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(round, a, out);
 }
 
-Ref<NDArray> nd::rint(Variant a) {
+Ref<NDArray> nd::trunc(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(trunc, a, out);
+}
+
+Ref<NDArray> nd::rint(Variant a, const Ref<NDArray>& out) {
 	// Actually uses nearbyint because rint can throw, which is undesirable in our case, and unlike numpy's behavior.
-	return UNARY_MAP(nearbyint, a);
+	return UNARY_MAP(nearbyint, a, out);
 }
 
-Ref<NDArray> nd::equal(Variant a, Variant b) {
-	return BINARY_MAP(equal_to, a, b);
+Ref<NDArray> nd::equal(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(equal_to, a, b, out);
 }
 
-Ref<NDArray> nd::not_equal(Variant a, Variant b) {
-	return BINARY_MAP(not_equal_to, a, b);
+Ref<NDArray> nd::not_equal(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(not_equal_to, a, b, out);
 }
 
-Ref<NDArray> nd::greater(Variant a, Variant b) {
-	return BINARY_MAP(greater, a, b);
+Ref<NDArray> nd::greater(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(greater, a, b, out);
 }
 
-Ref<NDArray> nd::greater_equal(Variant a, Variant b) {
-	return BINARY_MAP(greater_equal, a, b);
+Ref<NDArray> nd::greater_equal(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(greater_equal, a, b, out);
 }
 
-Ref<NDArray> nd::less(Variant a, Variant b) {
-	return BINARY_MAP(less, a, b);
+Ref<NDArray> nd::less(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(less, a, b, out);
 }
 
-Ref<NDArray> nd::less_equal(Variant a, Variant b) {
-	return BINARY_MAP(less_equal, a, b);
+Ref<NDArray> nd::less_equal(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(less_equal, a, b, out);
 }
 
-Ref<NDArray> nd::logical_and(Variant a, Variant b) {
-	return BINARY_MAP(logical_and, a, b);
+Ref<NDArray> nd::logical_and(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(logical_and, a, b, out);
 }
 
-Ref<NDArray> nd::logical_or(Variant a, Variant b) {
-	return BINARY_MAP(logical_or, a, b);
+Ref<NDArray> nd::logical_or(Variant a, Variant b, const Ref<NDArray>& out) {
+	return BINARY_MAP(logical_or, a, b, out);
 }
 
-Ref<NDArray> nd::logical_xor(Variant a, Variant b) {
-    return BINARY_MAP(logical_xor, a, b);
+Ref<NDArray> nd::logical_xor(Variant a, Variant b, const Ref<NDArray>& out) {
+    return BINARY_MAP(logical_xor, a, b, out);
 }
 
-Ref<NDArray> nd::logical_not(Variant a) {
-	return UNARY_MAP(logical_not, a);
+Ref<NDArray> nd::logical_not(Variant a, const Ref<NDArray>& out) {
+	return UNARY_MAP(logical_not, a, out);
 }
 
-Ref<NDArray> nd::all(Variant a, Variant axes) {
-    return REDUCTION(all, a, axes);
+Ref<NDArray> nd::all(Variant a, Variant axes, const Ref<NDArray>& out) {
+    return REDUCTION(all, a, axes, out);
 }
 
-Ref<NDArray> nd::any(Variant a, Variant axes) {
-    return REDUCTION(any, a, axes);
+Ref<NDArray> nd::any(Variant a, Variant axes, const Ref<NDArray>& out) {
+    return REDUCTION(any, a, axes, out);
 }
 
-Ref<NDArray> nd::dot(Variant a, Variant b) {
-    return BINARY_MAP(dot, a, b);
+Ref<NDArray> nd::dot(Variant a, Variant b, const Ref<NDArray>& out) {
+	return map_variants_as_arrays_with_target([](const va::VArrayTarget target, const va::VArray& a, const va::VArray& b) {
+		va::dot(target, a, b);
+	}, out, a, b);
 }
 
-Ref<NDArray> nd::reduce_dot(Variant a, Variant b, Variant axes) {
+Ref<NDArray> nd::reduce_dot(Variant a, Variant b, Variant axes, const Ref<NDArray>& out) {
 	return reduction([](const va::VArrayTarget target, const va::Axes& axes, const va::VArray& a, const va::VArray& b) {
 		va::reduce_dot(target, a, b, axes);
-	}, axes, a, b);
+	}, out, axes, a, b);
+}
+
+Ref<NDArray> nd::matmul(Variant a, Variant b, const Ref<NDArray>& out) {
+	return map_variants_as_arrays_with_target([](const va::VArrayTarget target, const va::VArray& a, const va::VArray& b) {
+		va::matmul(target, a, b);
+	}, out, a, b);
 }
 
-Ref<NDArray> nd::matmul(Variant a, Variant b) {
-	return BINARY_MAP(matmul, a, b);
+Ref<NDArray> nd::evaluate(const String& expression, const Dictionary& variables) {
+	try {
+		std::optional<va::VArray> result;
+		va::evaluate(&result, *string_as_expression(expression, variables));
+		return { memnew(NDArray(std::move(*result))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
 }
@@ -8,6 +8,8 @@
 #include "godot_cpp/classes/object.hpp"       // for Object
 #include "godot_cpp/classes/wrapped.hpp"      // for GDCLASS
 #include "godot_cpp/core/class_db.hpp"        // for ClassDB (ptr only), DEFVAL
+#include "godot_cpp/variant/dictionary.hpp"   // for Dictionary
+#include "godot_cpp/variant/string.hpp"       // for String
 #include "godot_cpp/variant/string_name.hpp"  // for StringName
 #include "godot_cpp/variant/variant.hpp"      // for Variant
 #include "ndarray.h"                          // for NDArray
@@ -42,6 +44,14 @@ public:
 	// Property access.
 	static uint64_t size_of_dtype_in_bytes(DType dtype);
 
+	// Configuration.
+	static void set_memory_pool_limit(int64_t max_bytes);
+	static int64_t get_memory_pool_limit();
+	static void set_num_threads(int64_t num_threads);
+	static int64_t get_num_threads();
+	static void set_parallel_threshold(int64_t num_elements);
+	static int64_t get_parallel_threshold();
+
 	// Array interpretation.
 	static Ref<NDArray> as_array(Variant array, DType dtype = DType::DTypeMax);
 	static Ref<NDArray> array(Variant array, DType dtype = DType::DTypeMax);
@@ -64,81 +74,103 @@ public:
 	static Ref<NDArray> unstack(Variant v, int64_t axis);
 
 	// Basic math functions.
-	static Ref<NDArray> add(Variant a, Variant b);
-	static Ref<NDArray> subtract(Variant a, Variant b);
-	static Ref<NDArray> multiply(Variant a, Variant b);
-	static Ref<NDArray> divide(Variant a, Variant b);
-	static Ref<NDArray> remainder(Variant a, Variant b);
-	static Ref<NDArray> pow(Variant a, Variant b);
-
-	static Ref<NDArray> minimum(Variant a, Variant b);
-	static Ref<NDArray> maximum(Variant a, Variant b);
-	static Ref<NDArray> clip(Variant a, Variant min, Variant max);
-
-	static Ref<NDArray> sign(Variant a);
-	static Ref<NDArray> abs(Variant a);
-	static Ref<NDArray> square(Variant a);
-	static Ref<NDArray> sqrt(Variant a);
-
-	static Ref<NDArray> exp(Variant a);
-	static Ref<NDArray> log(Variant a);
-
-	static Ref<NDArray> rad2deg(Variant a);
-	static Ref<NDArray> deg2rad(Variant a);
+	static Ref<NDArray> add(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> subtract(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> multiply(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> divide(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> remainder(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> pow(Variant a, Variant b, const Ref<NDArray>& out = {});
+
+	static Ref<NDArray> minimum(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> maximum(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> clip(Variant a, Variant min, Variant max, const Ref<NDArray>& out = {});
+
+	static Ref<NDArray> sign(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> abs(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> square(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> sqrt(Variant a, const Ref<NDArray>& out = {});
+
+	static Ref<NDArray> exp(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> log(Variant a, const Ref<NDArray>& out = {});
+
+	static Ref<NDArray> rad2deg(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> deg2rad(Variant a, const Ref<NDArray>& out = {});
 	
 	// Trigonometric functions.
-	static Ref<NDArray> sin(Variant a);
-	static Ref<NDArray> cos(Variant a);
-	static Ref<NDArray> tan(Variant a);
-	static Ref<NDArray> asin(Variant a);
-	static Ref<NDArray> acos(Variant a);
-	static Ref<NDArray> atan(Variant a);
-	static Ref<NDArray> atan2(Variant x1, Variant x2);
-
-	static Ref<NDArray> sinh(Variant a);
-	static Ref<NDArray> cosh(Variant a);
-	static Ref<NDArray> tanh(Variant a);
-	static Ref<NDArray> asinh(Variant a);
-	static Ref<NDArray> acosh(Variant a);
-	static Ref<NDArray> atanh(Variant a);
+	static Ref<NDArray> sin(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> cos(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> tan(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> asin(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> acos(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> atan(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> atan2(Variant x1, Variant x2, const Ref<NDArray>& out = {});
+
+	static Ref<NDArray> sinh(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> cosh(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> tanh(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> asinh(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> acosh(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> atanh(Variant a, const Ref<NDArray>& out = {});
 
 	// Reductions.
-	static Ref<NDArray> sum(Variant a, Variant axes);
-	static Ref<NDArray> prod(Variant a, Variant axes);
-	static Ref<NDArray> mean(Variant a, Variant axes);
-	static Ref<NDArray> var(Variant a, Variant axes);
-	static Ref<NDArray> std(Variant a, Variant axes);
-	static Ref<NDArray> max(Variant a, Variant axes);
-	static Ref<NDArray> min(Variant a, Variant axes);
-	static Ref<NDArray> norm(Variant a, Variant ord, Variant axes);
+	static Ref<NDArray> sum(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> prod(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> mean(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> var(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> std(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> max(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> min(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Dictionary moments(Variant a, Variant axes);
+	static Ref<NDArray> argmax(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> argmin(Variant a, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> top_k(Variant a, int64_t k, int64_t axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> norm(Variant a, Variant ord, Variant axes, const Ref<NDArray>& out = {});
+
+	// Cumulative functions.
+	static Ref<NDArray> cumsum(Variant a, Variant axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> cumprod(Variant a, Variant axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> cummax(Variant a, Variant axis, const Ref<NDArray>& out = {});
+
+	// Histograms.
+	static Ref<NDArray> bincount(Variant a, Variant weights, int64_t min_length, const Ref<NDArray>& out = {});
+	static Ref<NDArray> histogram(Variant a, Variant bins, Variant range, const Ref<NDArray>& out = {});
+
+	// Sliding window reductions.
+	static Ref<NDArray> moving_sum(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> moving_mean(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> moving_min(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out = {});
+	static Ref<NDArray> moving_max(Variant a, int64_t window, int64_t axis, const Ref<NDArray>& out = {});
 
 	// Rounding.
-	static Ref<NDArray> floor(Variant a);
-	static Ref<NDArray> ceil(Variant a);
-	static Ref<NDArray> round(Variant a);
-	static Ref<NDArray> trunc(Variant a);
-	static Ref<NDArray> rint(Variant a);
+	static Ref<NDArray> floor(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> ceil(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> round(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> trunc(Variant a, const Ref<NDArray>& out = {});
+	static Ref<NDArray> rint(Variant a, const Ref<NDArray>& out = {});
 
 	// Comparisons.
-	static Ref<NDArray> equal(Variant a, Variant b);
-	static Ref<NDArray> not_equal(Variant a, Variant b);
-	static Ref<NDArray> greater(Variant a, Variant b);
-	static Ref<NDArray> greater_equal(Variant a, Variant b);
-	static Ref<NDArray> less(Variant a, Variant b);
-	static Ref<NDArray> less_equal(Variant a, Variant b);
+	static Ref<NDArray> equal(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> not_equal(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> greater(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> greater_equal(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> less(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> less_equal(Variant a, Variant b, const Ref<NDArray>& out = {});
 
 	// Logical.
-	static Ref<NDArray> logical_and(Variant a, Variant b);
-	static Ref<NDArray> logical_or(Variant a, Variant b);
-	static Ref<NDArray> logical_xor(Variant a, Variant b);
-	static Ref<NDArray> logical_not(Variant a);
-    static Ref<NDArray> all(Variant a, Variant axes);
-    static Ref<NDArray> any(Variant a, Variant axes);
+	static Ref<NDArray> logical_and(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> logical_or(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> logical_xor(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> logical_not(Variant a, const Ref<NDArray>& out = {});
+    static Ref<NDArray> all(Variant a, Variant axes, const Ref<NDArray>& out = {});
+    static Ref<NDArray> any(Variant a, Variant axes, const Ref<NDArray>& out = {});
 
 	// Linalg.
-	static Ref<NDArray> dot(Variant a, Variant b);
-	static Ref<NDArray> reduce_dot(Variant a, Variant b, Variant axes);
-	static Ref<NDArray> matmul(Variant a, Variant b);
+	static Ref<NDArray> dot(Variant a, Variant b, const Ref<NDArray>& out = {});
+	static Ref<NDArray> reduce_dot(Variant a, Variant b, Variant axes, const Ref<NDArray>& out = {});
+	static Ref<NDArray> matmul(Variant a, Variant b, const Ref<NDArray>& out = {});
+
+	// Expressions.
+	static Ref<NDArray> evaluate(const String& expression, const Dictionary& variables);
 };
 
 VARIANT_ENUM_CAST(nd::DType);
@@ -7,8 +7,13 @@
 #include <vatensor/trigonometry.h>                 // for acos, acosh, asin
 #include <vatensor/vmath.h>                        // for abs, add, deg2rad
 #include <algorithm>                               // for copy
+#include <array>                                   // for array
+#include <cstddef>                                 // for size_t
 #include <functional>                              // for function
+#include <optional>                                // for optional
 #include <stdexcept>                               // for runtime_error
+#include <tuple>                                   // for tuple, apply
+#include <utility>                                 // for move
 #include <variant>                                 // for visit
 #include <vatensor/linalg.h>
 
@@ -124,6 +129,15 @@ void NDArray::_bind_methods() {
 	godot::ClassDB::bind_method(D_METHOD("assign_dot", "a", "b"), &NDArray::assign_dot);
 	godot::ClassDB::bind_method(D_METHOD("assign_reduce_dot", "a", "b", "axes"), &NDArray::assign_reduce_dot, DEFVAL(nullptr), DEFVAL(nullptr), DEFVAL(nullptr));
 	godot::ClassDB::bind_method(D_METHOD("assign_matmul", "a", "b"), &NDArray::assign_matmul);
+
+	godot::ClassDB::bind_method(D_METHOD("add", "b", "out"), &NDArray::add, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("subtract", "b", "out"), &NDArray::subtract, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("multiply", "b", "out"), &NDArray::multiply, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("divide", "b", "out"), &NDArray::divide, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("remainder", "b", "out"), &NDArray::remainder, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("pow", "b", "out"), &NDArray::pow, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("minimum", "b", "out"), &NDArray::minimum, DEFVAL(nullptr));
+	godot::ClassDB::bind_method(D_METHOD("maximum", "b", "out"), &NDArray::maximum, DEFVAL(nullptr));
 }
 
 NDArray::NDArray() = default;
@@ -158,6 +172,18 @@ Variant NDArray::as_type(va::DType dtype) const {
 	return nd::as_array(this, dtype);
 }
 
+// Returns true if all arguments are integers, and sets index to them.
+static bool variants_as_index(const Variant **args, const GDExtensionInt arg_count, va::strides_type& index) {
+	index.resize(arg_count);
+	for (GDExtensionInt i = 0; i < arg_count; ++i) {
+		if (args[i]->get_type() != Variant::INT) {
+			return false;
+		}
+		index[i] = static_cast<int64_t>(*args[i]);
+	}
+	return true;
+}
+
 void NDArray::set(const Variant **args, GDExtensionInt arg_count, GDExtensionCallError &error) {
 	if (arg_count < 1) {
 		ERR_FAIL_MSG("First argument (value) must be set. Ignoring assignment.");
@@ -165,23 +191,29 @@ void NDArray::set(const Variant **args, GDExtensionInt arg_count, GDExtensionCal
 
 	try {
 		const Variant &value = *args[0];
-		// todo don't need slices if arg_count == 1
-		auto slices = variants_as_slice_vector(args + 1, arg_count - 1, error);
-		va::VArray sliced = arg_count == 1 ? array : array.slice(slices);
+		const bool is_scalar_value = value.get_type() == Variant::INT || value.get_type() == Variant::FLOAT || value.get_type() == Variant::BOOL;
+
+		// Writing a single element, e.g. a.set(5, 1, 2): skip building slices.
+		va::strides_type index;
+		if (is_scalar_value && arg_count > 1 && static_cast<std::size_t>(arg_count - 1) == array.dimension() && variants_as_index(args + 1, arg_count - 1, index)) {
+			array.set_single_value(index, std::get<va::VConstant>(variant_as_data(value)));
+			return;
+		}
+
+		va::VArray sliced = arg_count == 1 ? array : array.slice(variants_as_slice_vector(args + 1, arg_count - 1, error));
 
 		switch (value.get_type()) {
 			case Variant::INT:
-				array.fill(static_cast<int64_t>(value));
+				sliced.fill(static_cast<int64_t>(value));
 				return;
 			case Variant::FLOAT:
-				array.fill(static_cast<double_t>(value));
+				sliced.fill(static_cast<double_t>(value));
+				return;
+			case Variant::BOOL:
+				sliced.fill(static_cast<bool>(value));
 				return;
-			// TODO We could optimize more assignments of literals.
-			//  Just need to figure out how, ideally without duplicating code - as_array already does much type checking work.
 			default:
-				va::VArray a_ = variant_as_array(value);
-
-				array.set_with_array(a_);
+				sliced.set_with_array(variant_as_array(value));
 				return;
 		}
 	}
@@ -285,7 +317,7 @@ Array NDArray::to_godot_array() const {
 }
 
 template <typename Visitor, typename... Args>
-void map_variants_as_arrays_inplace(Visitor visitor, Args... args) {
+void map_variants_as_arrays_inplace(Visitor visitor, const Args&... args) {
     try {
         visitor(variant_as_array(args)...);
     }
@@ -294,8 +326,25 @@ void map_variants_as_arrays_inplace(Visitor visitor, Args... args) {
     }
 }
 
+// Like map_variants_as_arrays_inplace, but passes scalars as constants rather than 0-d arrays.
+template <typename Visitor, typename... Args>
+void map_variants_as_data_inplace(Visitor visitor, const Args&... args) {
+    try {
+        std::array<std::optional<va::VArray>, sizeof...(Args)> storage;
+        std::size_t storage_index = 0;
+        const std::tuple data { variant_as_data_ref(args, storage[storage_index++])... };
+
+        std::apply([&visitor](const auto&... data) {
+            visitor(data...);
+        }, data);
+    }
+    catch (std::runtime_error& error) {
+        ERR_FAIL_MSG(error.what());
+    }
+}
+
 template <typename Visitor, typename... Args>
-inline void reduction_inplace(Visitor visitor, Variant axes, Args... args) {
+inline void reduction_inplace(Visitor visitor, const Variant& axes, const Args&... args) {
 	try {
 		const auto axes_ = variant_to_axes(axes);
 
@@ -308,29 +357,25 @@ inline void reduction_inplace(Visitor visitor, Variant axes, Args... args) {
 
 #define UNARY_MAP(func, varray1) \
 	map_variants_as_arrays_inplace([this](const va::VArray& varray) {\
-		auto compute_variant = array.to_compute_variant();\
-        va::func(&compute_variant, varray);\
+		va::func(&array.compute_variant_for_write(), varray);\
     }, (varray1));\
     return {this}
 
 #define BINARY_MAP(func, varray1, varray2) \
-	map_variants_as_arrays_inplace([this](const va::VArray& a, const va::VArray& b) {\
-		auto compute_variant = array.to_compute_variant();\
-        va::func(&compute_variant, a, b);\
+	map_variants_as_data_inplace([this](const va::VDataRef& a, const va::VDataRef& b) {\
+		va::func(&array.compute_variant_for_write(), a, b);\
     }, (varray1), (varray2));\
     return {this}
 
 #define TERNARY_MAP(func, varray1, varray2, varray3) \
 	map_variants_as_arrays_inplace([this](const va::VArray& a, const va::VArray& b, const va::VArray& c) {\
-		auto compute_variant = array.to_compute_variant();\
-        va::func(&compute_variant, a, b, c);\
+		va::func(&array.compute_variant_for_write(), a, b, c);\
     }, (varray1), (varray2), (varray3));\
     return {this}
 
 #define REDUCTION(func, varray1, axes1) \
-	reduction_inplace([this](const va::Axes& axes, const va::VArray& array) {\
-		auto compute_variant = array.to_compute_variant();\
-		va::func(&compute_variant, array, axes);\
+	reduction_inplace([this](const va::Axes& axes, const va::VArray& a) {\
+		va::func(&array.compute_variant_for_write(), a, axes);\
 	}, (axes1), (varray1));\
 	return {this}
 
@@ -577,17 +622,79 @@ Ref<NDArray> NDArray::assign_any(Variant a, Variant axes) {
 }
 
 Ref<NDArray> NDArray::assign_dot(Variant a, Variant b) {
-	BINARY_MAP(dot, a, b);
+	map_variants_as_arrays_inplace([this](const va::VArray& a, const va::VArray& b) {
+		va::dot(&array.compute_variant_for_write(), a, b);
+	}, a, b);
+	return {this};
 }
 
 Ref<NDArray> NDArray::assign_reduce_dot(Variant a, Variant b, Variant axes) {
 	reduction_inplace([this](const va::Axes& axes, const va::VArray& a, const va::VArray& b) {
-		auto compute_variant = array.to_compute_variant();\
-		va::reduce_dot(&compute_variant, a, b, axes);
+		va::reduce_dot(&array.compute_variant_for_write(), a, b, axes);
 	}, axes, a, b);
 	return {this};
 }
 
 Ref<NDArray> NDArray::assign_matmul(Variant a, Variant b) {
-	BINARY_MAP(matmul, a, b);
+	map_variants_as_arrays_inplace([this](const va::VArray& a, const va::VArray& b) {
+		va::matmul(&array.compute_variant_for_write(), a, b);
+	}, a, b);
+	return {this};
+}
+
+// Calls the visitor with this array and b, writing to out if given, or to a new array otherwise.
+template <typename Visitor>
+Ref<NDArray> typed_binary_map(Visitor visitor, const va::VArray& a, const Ref<NDArray>& b, const Ref<NDArray>& out) {
+	ERR_FAIL_COND_V_MSG(b.is_null(), {}, "The argument must be an NDArray.");
+
+	try {
+		if (out.is_valid()) {
+			visitor(&out->array.compute_variant_for_write(), a, b->array);
+			return out;
+		}
+
+		std::optional<va::VArray> result;
+		visitor(&result, a, b->array);
+		return { memnew(NDArray(std::move(*result))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+#define TYPED_BINARY_MAP(func, b, out) \
+	return typed_binary_map([](const va::VArrayTarget target, const va::VArray& a, const va::VArray& b) {\
+		va::func(target, a, b);\
+	}, array, (b), (out))
+
+Ref<NDArray> NDArray::add(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(add, b, out);
+}
+
+Ref<NDArray> NDArray::subtract(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(subtract, b, out);
+}
+
+Ref<NDArray> NDArray::multiply(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(multiply, b, out);
+}
+
+Ref<NDArray> NDArray::divide(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(divide, b, out);
+}
+
+Ref<NDArray> NDArray::remainder(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(remainder, b, out);
+}
+
+Ref<NDArray> NDArray::pow(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(pow, b, out);
+}
+
+Ref<NDArray> NDArray::minimum(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(minimum, b, out);
+}
+
+Ref<NDArray> NDArray::maximum(const Ref<NDArray>& b, const Ref<NDArray>& out) const {
+	TYPED_BINARY_MAP(maximum, b, out);
 }
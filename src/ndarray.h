@@ -146,6 +146,17 @@ public:
 	Ref<NDArray> assign_dot(Variant a, Variant b);
 	Ref<NDArray> assign_reduce_dot(Variant a, Variant b, Variant axes);
 	Ref<NDArray> assign_matmul(Variant a, Variant b);
+
+	// Typed element-wise functions.
+	// These take and return NDArray directly, so they skip the Variant conversions of the nd functions.
+	Ref<NDArray> add(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> subtract(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> multiply(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> divide(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> remainder(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> pow(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> minimum(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
+	Ref<NDArray> maximum(const Ref<NDArray>& b, const Ref<NDArray>& out) const;
 };
 
 #endif
@@ -0,0 +1,291 @@
+#include "ndexpression.h"
+
+#include <vatensor/comparison.h>            // for equal_to, greater, greate...
+#include <vatensor/logical.h>               // for logical_and, logical_not
+#include <vatensor/round.h>                 // for ceil, floor, nearbyint
+#include <vatensor/trigonometry.h>          // for acos, acosh, asin, asinh
+#include <vatensor/vmath.h>                 // for abs, add, deg2rad, divide
+#include <optional>                         // for optional
+#include <stdexcept>                        // for runtime_error
+#include "gdconvert/conversion_expression.h"  // for variant_as_expression
+#include "godot_cpp/core/class_db.hpp"      // for D_METHOD, ClassDB
+#include "godot_cpp/core/error_macros.hpp"  // for ERR_FAIL_V_MSG
+#include "godot_cpp/core/memory.hpp"        // for _post_initialize, memnew
+#include "vatensor/varray.h"                // for VArray, VArrayTarget, VData
+
+using namespace godot;
+
+void NDExpression::_bind_methods() {
+	godot::ClassDB::bind_method(D_METHOD("evaluate"), &NDExpression::evaluate);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("of", "a"), &NDExpression::of);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("add", "a", "b"), &NDExpression::add);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("subtract", "a", "b"), &NDExpression::subtract);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("multiply", "a", "b"), &NDExpression::multiply);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("divide", "a", "b"), &NDExpression::divide);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("remainder", "a", "b"), &NDExpression::remainder);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("pow", "a", "b"), &NDExpression::pow);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("minimum", "a", "b"), &NDExpression::minimum);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("maximum", "a", "b"), &NDExpression::maximum);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("sign", "a"), &NDExpression::sign);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("abs", "a"), &NDExpression::abs);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("square", "a"), &NDExpression::square);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("sqrt", "a"), &NDExpression::sqrt);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("exp", "a"), &NDExpression::exp);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("log", "a"), &NDExpression::log);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("rad2deg", "a"), &NDExpression::rad2deg);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("deg2rad", "a"), &NDExpression::deg2rad);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("sin", "a"), &NDExpression::sin);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("cos", "a"), &NDExpression::cos);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("tan", "a"), &NDExpression::tan);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("asin", "a"), &NDExpression::asin);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("acos", "a"), &NDExpression::acos);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("atan", "a"), &NDExpression::atan);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("atan2", "x1", "x2"), &NDExpression::atan2);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("sinh", "a"), &NDExpression::sinh);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("cosh", "a"), &NDExpression::cosh);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("tanh", "a"), &NDExpression::tanh);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("asinh", "a"), &NDExpression::asinh);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("acosh", "a"), &NDExpression::acosh);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("atanh", "a"), &NDExpression::atanh);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("floor", "a"), &NDExpression::floor);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("ceil", "a"), &NDExpression::ceil);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("round", "a"), &NDExpression::round);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("trunc", "a"), &NDExpression::trunc);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("rint", "a"), &NDExpression::rint);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("equal", "a", "b"), &NDExpression::equal);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("not_equal", "a", "b"), &NDExpression::not_equal);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("greater", "a", "b"), &NDExpression::greater);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("greater_equal", "a", "b"), &NDExpression::greater_equal);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("less", "a", "b"), &NDExpression::less);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("less_equal", "a", "b"), &NDExpression::less_equal);
+
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("logical_and", "a", "b"), &NDExpression::logical_and);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("logical_or", "a", "b"), &NDExpression::logical_or);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("logical_xor", "a", "b"), &NDExpression::logical_xor);
+	godot::ClassDB::bind_static_method("NDExpression", D_METHOD("logical_not", "a"), &NDExpression::logical_not);
+}
+
+NDExpression::NDExpression() = default;
+NDExpression::~NDExpression() = default;
+
+Ref<NDArray> NDExpression::evaluate() const {
+	ERR_FAIL_COND_V_MSG(expression == nullptr, {}, "The expression is empty.");
+
+	try {
+		std::optional<va::VArray> result;
+		va::evaluate(&result, *expression);
+		return { memnew(NDArray(result.value())) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+template <typename Visitor, typename... Args>
+Ref<NDExpression> map_variants_as_expressions(Visitor visitor, Args... args) {
+	try {
+		return { memnew(NDExpression(visitor(variant_as_expression(args)...))) };
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_V_MSG({}, error.what());
+	}
+}
+
+#define UNARY_EXPRESSION(func, variant1) \
+	map_variants_as_expressions([](va::VExpressionPtr a) {\
+		return va::make_unary(&va::func, std::move(a));\
+	}, (variant1))
+
+#define BINARY_EXPRESSION(func, variant1, variant2) \
+	map_variants_as_expressions([](va::VExpressionPtr a, va::VExpressionPtr b) {\
+		return va::make_binary(&va::func, std::move(a), std::move(b));\
+	}, (variant1), (variant2))
+
+Ref<NDExpression> NDExpression::of(Variant a) {
+	return map_variants_as_expressions([](va::VExpressionPtr a) { return a; }, a);
+}
+
+Ref<NDExpression> NDExpression::add(Variant a, Variant b) {
+	return BINARY_EXPRESSION(add, a, b);
+}
+
+Ref<NDExpression> NDExpression::subtract(Variant a, Variant b) {
+	return BINARY_EXPRESSION(subtract, a, b);
+}
+
+Ref<NDExpression> NDExpression::multiply(Variant a, Variant b) {
+	return BINARY_EXPRESSION(multiply, a, b);
+}
+
+Ref<NDExpression> NDExpression::divide(Variant a, Variant b) {
+	return BINARY_EXPRESSION(divide, a, b);
+}
+
+Ref<NDExpression> NDExpression::remainder(Variant a, Variant b) {
+	return BINARY_EXPRESSION(remainder, a, b);
+}
+
+Ref<NDExpression> NDExpression::pow(Variant a, Variant b) {
+	return BINARY_EXPRESSION(pow, a, b);
+}
+
+Ref<NDExpression> NDExpression::minimum(Variant a, Variant b) {
+	return BINARY_EXPRESSION(minimum, a, b);
+}
+
+Ref<NDExpression> NDExpression::maximum(Variant a, Variant b) {
+	return BINARY_EXPRESSION(maximum, a, b);
+}
+
+Ref<NDExpression> NDExpression::sign(Variant a) {
+	return UNARY_EXPRESSION(sign, a);
+}
+
+Ref<NDExpression> NDExpression::abs(Variant a) {
+	return UNARY_EXPRESSION(abs, a);
+}
+
+Ref<NDExpression> NDExpression::square(Variant a) {
+	return UNARY_EXPRESSION(square, a);
+}
+
+Ref<NDExpression> NDExpression::sqrt(Variant a) {
+	return UNARY_EXPRESSION(sqrt, a);
+}
+
+Ref<NDExpression> NDExpression::exp(Variant a) {
+	return UNARY_EXPRESSION(exp, a);
+}
+
+Ref<NDExpression> NDExpression::log(Variant a) {
+	return UNARY_EXPRESSION(log, a);
+}
+
+Ref<NDExpression> NDExpression::rad2deg(Variant a) {
+	return UNARY_EXPRESSION(rad2deg, a);
+}
+
+Ref<NDExpression> NDExpression::deg2rad(Variant a) {
+	return UNARY_EXPRESSION(deg2rad, a);
+}
+
+Ref<NDExpression> NDExpression::sin(Variant a) {
+	return UNARY_EXPRESSION(sin, a);
+}
+
+Ref<NDExpression> NDExpression::cos(Variant a) {
+	return UNARY_EXPRESSION(cos, a);
+}
+
+Ref<NDExpression> NDExpression::tan(Variant a) {
+	return UNARY_EXPRESSION(tan, a);
+}
+
+Ref<NDExpression> NDExpression::asin(Variant a) {
+	return UNARY_EXPRESSION(asin, a);
+}
+
+Ref<NDExpression> NDExpression::acos(Variant a) {
+	return UNARY_EXPRESSION(acos, a);
+}
+
+Ref<NDExpression> NDExpression::atan(Variant a) {
+	return UNARY_EXPRESSION(atan, a);
+}
+
+Ref<NDExpression> NDExpression::atan2(Variant x1, Variant x2) {
+	return BINARY_EXPRESSION(atan2, x1, x2);
+}
+
+Ref<NDExpression> NDExpression::sinh(Variant a) {
+	return UNARY_EXPRESSION(sinh, a);
+}
+
+Ref<NDExpression> NDExpression::cosh(Variant a) {
+	return UNARY_EXPRESSION(cosh, a);
+}
+
+Ref<NDExpression> NDExpression::tanh(Variant a) {
+	return UNARY_EXPRESSION(tanh, a);
+}
+
+Ref<NDExpression> NDExpression::asinh(Variant a) {
+	return UNARY_EXPRESSION(asinh, a);
+}
+
+Ref<NDExpression> NDExpression::acosh(Variant a) {
+	return UNARY_EXPRESSION(acosh, a);
+}
+
+Ref<NDExpression> NDExpression::atanh(Variant a) {
+	return UNARY_EXPRESSION(atanh, a);
+}
+
+Ref<NDExpression> NDExpression::floor(Variant a) {
+	return UNARY_EXPRESSION(floor, a);
+}
+
+Ref<NDExpression> NDExpression::ceil(Variant a) {
+	return UNARY_EXPRESSION(ceil, a);
+}
+
+Ref<NDExpression> NDExpression::round(Variant a) {
+	return UNARY_EXPRESSION(round, a);
+}
+
+Ref<NDExpression> NDExpression::trunc(Variant a) {
+	return UNARY_EXPRESSION(trunc, a);
+}
+
+Ref<NDExpression> NDExpression::rint(Variant a) {
+	return UNARY_EXPRESSION(nearbyint, a);
+}
+
+Ref<NDExpression> NDExpression::equal(Variant a, Variant b) {
+	return BINARY_EXPRESSION(equal_to, a, b);
+}
+
+Ref<NDExpression> NDExpression::not_equal(Variant a, Variant b) {
+	return BINARY_EXPRESSION(not_equal_to, a, b);
+}
+
+Ref<NDExpression> NDExpression::greater(Variant a, Variant b) {
+	return BINARY_EXPRESSION(greater, a, b);
+}
+
+Ref<NDExpression> NDExpression::greater_equal(Variant a, Variant b) {
+	return BINARY_EXPRESSION(greater_equal, a, b);
+}
+
+Ref<NDExpression> NDExpression::less(Variant a, Variant b) {
+	return BINARY_EXPRESSION(less, a, b);
+}
+
+Ref<NDExpression> NDExpression::less_equal(Variant a, Variant b) {
+	return BINARY_EXPRESSION(less_equal, a, b);
+}
+
+Ref<NDExpression> NDExpression::logical_and(Variant a, Variant b) {
+	return BINARY_EXPRESSION(logical_and, a, b);
+}
+
+Ref<NDExpression> NDExpression::logical_or(Variant a, Variant b) {
+	return BINARY_EXPRESSION(logical_or, a, b);
+}
+
+Ref<NDExpression> NDExpression::logical_xor(Variant a, Variant b) {
+	return BINARY_EXPRESSION(logical_xor, a, b);
+}
+
+Ref<NDExpression> NDExpression::logical_not(Variant a) {
+	return UNARY_EXPRESSION(logical_not, a);
+}
@@ -0,0 +1,103 @@
+#ifndef NUMDOT_NDEXPRESSION_H
+#define NUMDOT_NDEXPRESSION_H
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "vatensor/auto_defines.h"
+#include <godot_cpp/classes/ref_counted.hpp>  // for RefCounted
+#include <godot_cpp/variant/variant.hpp>      // for Variant
+#include <utility>                            // for move
+#include "godot_cpp/classes/ref.hpp"          // for Ref
+#include "godot_cpp/classes/wrapped.hpp"      // for GDCLASS
+#include "ndarray.h"                          // for NDArray
+#include "vatensor/vexpression.h"             // for VExpressionPtr
+namespace godot { class ClassDB; }
+
+using namespace godot;
+
+// Element-wise functions that are only computed once evaluate() is called.
+// Evaluating all functions at once avoids full size temporary arrays between them.
+class NDExpression : public RefCounted {
+	GDCLASS(NDExpression, RefCounted)
+
+private:
+
+protected:
+	static void _bind_methods();
+
+public:
+	va::VExpressionPtr expression;
+
+	explicit NDExpression(va::VExpressionPtr expression) : expression(std::move(expression)) {};
+
+	NDExpression();
+	~NDExpression() override;
+
+	Ref<NDArray> evaluate() const;
+
+	// Leaves.
+	static Ref<NDExpression> of(Variant a);
+
+	// Basic math functions.
+	static Ref<NDExpression> add(Variant a, Variant b);
+	static Ref<NDExpression> subtract(Variant a, Variant b);
+	static Ref<NDExpression> multiply(Variant a, Variant b);
+	static Ref<NDExpression> divide(Variant a, Variant b);
+	static Ref<NDExpression> remainder(Variant a, Variant b);
+	static Ref<NDExpression> pow(Variant a, Variant b);
+
+	static Ref<NDExpression> minimum(Variant a, Variant b);
+	static Ref<NDExpression> maximum(Variant a, Variant b);
+
+	static Ref<NDExpression> sign(Variant a);
+	static Ref<NDExpression> abs(Variant a);
+	static Ref<NDExpression> square(Variant a);
+	static Ref<NDExpression> sqrt(Variant a);
+	static Ref<NDExpression> exp(Variant a);
+	static Ref<NDExpression> log(Variant a);
+
+	static Ref<NDExpression> rad2deg(Variant a);
+	static Ref<NDExpression> deg2rad(Variant a);
+
+	// Trigonometric functions.
+	static Ref<NDExpression> sin(Variant a);
+	static Ref<NDExpression> cos(Variant a);
+	static Ref<NDExpression> tan(Variant a);
+	static Ref<NDExpression> asin(Variant a);
+	static Ref<NDExpression> acos(Variant a);
+	static Ref<NDExpression> atan(Variant a);
+	static Ref<NDExpression> atan2(Variant x1, Variant x2);
+
+	// Hyperbolic functions.
+	static Ref<NDExpression> sinh(Variant a);
+	static Ref<NDExpression> cosh(Variant a);
+	static Ref<NDExpression> tanh(Variant a);
+	static Ref<NDExpression> asinh(Variant a);
+	static Ref<NDExpression> acosh(Variant a);
+	static Ref<NDExpression> atanh(Variant a);
+
+	// Rounding.
+	static Ref<NDExpression> floor(Variant a);
+	static Ref<NDExpression> ceil(Variant a);
+	static Ref<NDExpression> round(Variant a);
+	static Ref<NDExpression> trunc(Variant a);
+	static Ref<NDExpression> rint(Variant a);
+
+	// Comparison.
+	static Ref<NDExpression> equal(Variant a, Variant b);
+	static Ref<NDExpression> not_equal(Variant a, Variant b);
+	static Ref<NDExpression> greater(Variant a, Variant b);
+	static Ref<NDExpression> greater_equal(Variant a, Variant b);
+	static Ref<NDExpression> less(Variant a, Variant b);
+	static Ref<NDExpression> less_equal(Variant a, Variant b);
+
+	// Logical.
+	static Ref<NDExpression> logical_and(Variant a, Variant b);
+	static Ref<NDExpression> logical_or(Variant a, Variant b);
+	static Ref<NDExpression> logical_xor(Variant a, Variant b);
+	static Ref<NDExpression> logical_not(Variant a);
+};
+
+#endif
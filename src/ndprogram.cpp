@@ -0,0 +1,127 @@
+#include "ndprogram.h"
+
+#include <vatensor/reduce.h>                  // for sum, prod, mean, var, std, max, min, argmax, argmin, norm_l2
+#include <stdexcept>                          // for runtime_error
+#include <string>                             // for string, to_string
+#include <unordered_map>                      // for unordered_map
+#include "gdconvert/conversion_array.h"       // for variant_as_array, variant_as_data
+#include "gdconvert/conversion_axes.h"        // for variant_to_axes
+#include "gdconvert/conversion_expression.h"  // for variant_as_expression, string_as_expression
+#include "godot_cpp/core/class_db.hpp"        // for D_METHOD, ClassDB
+#include "godot_cpp/core/error_macros.hpp"    // for ERR_FAIL_MSG
+#include "vatensor/vparse.h"                  // for find_unary_function, find_binary_function
+
+using namespace godot;
+
+void NDProgram::_bind_methods() {
+	godot::ClassDB::bind_method(D_METHOD("assign", "out", "value"), &NDProgram::assign);
+	godot::ClassDB::bind_method(D_METHOD("evaluate", "out", "expression", "variables"), &NDProgram::evaluate, DEFVAL(Dictionary()));
+	godot::ClassDB::bind_method(D_METHOD("call_function", "out", "function", "args"), &NDProgram::call_function);
+	godot::ClassDB::bind_method(D_METHOD("reduce", "out", "function", "a", "axes"), &NDProgram::reduce, DEFVAL(nullptr));
+
+	godot::ClassDB::bind_method(D_METHOD("run"), &NDProgram::run);
+	godot::ClassDB::bind_method(D_METHOD("clear"), &NDProgram::clear);
+	godot::ClassDB::bind_method(D_METHOD("get_step_count"), &NDProgram::get_step_count);
+}
+
+NDProgram::NDProgram() = default;
+NDProgram::~NDProgram() = default;
+
+static va::ReductionFunction reduction_by_name(const StringName& name) {
+	static const std::unordered_map<std::string, va::ReductionFunction> functions {
+		{ "sum", &va::sum },
+		{ "prod", &va::prod },
+		{ "mean", &va::mean },
+		{ "var", &va::var },
+		{ "std", &va::std },
+		{ "max", &va::max },
+		{ "min", &va::min },
+		{ "all", &va::all },
+		{ "any", &va::any },
+		{ "argmax", &va::argmax },
+		{ "argmin", &va::argmin },
+		{ "norm", &va::norm_l2 },
+	};
+
+	const auto function = functions.find(String(name).utf8().get_data());
+	if (function == functions.end()) {
+		throw std::runtime_error("Unknown reduction: " + std::string(String(name).utf8().get_data()));
+	}
+	return function->second;
+}
+
+void NDProgram::assign(const Ref<NDArray>& out, const Variant& value) {
+	ERR_FAIL_COND_MSG(out.is_null(), "The out array must not be null.");
+
+	try {
+		program.assign(out->array, variant_as_expression(value));
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void NDProgram::evaluate(const Ref<NDArray>& out, const String& expression, const Dictionary& variables) {
+	ERR_FAIL_COND_MSG(out.is_null(), "The out array must not be null.");
+
+	try {
+		program.assign(out->array, string_as_expression(expression, variables));
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void NDProgram::call_function(const Ref<NDArray>& out, const StringName& function, const Array& args) {
+	ERR_FAIL_COND_MSG(out.is_null(), "The out array must not be null.");
+
+	try {
+		const std::string name = String(function).utf8().get_data();
+
+		if (const auto unary = va::find_unary_function(name)) {
+			if (args.size() != 1) {
+				throw std::runtime_error("Function '" + name + "' takes 1 argument, but got " + std::to_string(args.size()) + ".");
+			}
+			program.call(out->array, unary, variant_as_array(args[0]));
+		} else if (const auto binary = va::find_binary_function(name)) {
+			if (args.size() != 2) {
+				throw std::runtime_error("Function '" + name + "' takes 2 arguments, but got " + std::to_string(args.size()) + ".");
+			}
+			program.call(out->array, binary, variant_as_data(args[0]), variant_as_data(args[1]));
+		} else {
+			// Other functions, e.g. matmul, can't be recorded; failing here beats failing on every run.
+			throw std::runtime_error("Function '" + name + "' can't be recorded; only element-wise functions can be called in a program.");
+		}
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void NDProgram::reduce(const Ref<NDArray>& out, const StringName& function, const Variant& a, const Variant& axes) {
+	ERR_FAIL_COND_MSG(out.is_null(), "The out array must not be null.");
+
+	try {
+		program.reduce(out->array, reduction_by_name(function), variant_as_array(a), variant_to_axes(axes));
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void NDProgram::run() {
+	try {
+		program.run();
+	}
+	catch (std::runtime_error& error) {
+		ERR_FAIL_MSG(error.what());
+	}
+}
+
+void NDProgram::clear() {
+	program.steps.clear();
+}
+
+int64_t NDProgram::get_step_count() const {
+	return static_cast<int64_t>(program.steps.size());
+}
@@ -0,0 +1,50 @@
+#ifndef NUMDOT_NDPROGRAM_H
+#define NUMDOT_NDPROGRAM_H
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "vatensor/auto_defines.h"
+#include <godot_cpp/classes/ref_counted.hpp>  // for RefCounted
+#include <godot_cpp/variant/variant.hpp>      // for Variant
+#include <cstdint>                            // for int64_t
+#include "godot_cpp/classes/ref.hpp"          // for Ref
+#include "godot_cpp/classes/wrapped.hpp"      // for GDCLASS
+#include "godot_cpp/variant/array.hpp"        // for Array
+#include "godot_cpp/variant/dictionary.hpp"   // for Dictionary
+#include "godot_cpp/variant/string.hpp"       // for String
+#include "godot_cpp/variant/string_name.hpp"  // for StringName
+#include "ndarray.h"                          // for NDArray
+#include "vatensor/vprogram.h"                // for VProgram
+namespace godot { class ClassDB; }
+
+using namespace godot;
+
+// A sequence of steps that is recorded once, and can then be run many times.
+// Arguments are converted when recording, so running the steps skips the conversions of the nd functions.
+class NDProgram : public RefCounted {
+	GDCLASS(NDProgram, RefCounted)
+
+private:
+
+protected:
+	static void _bind_methods();
+
+public:
+	va::VProgram program;
+
+	NDProgram();
+	~NDProgram() override;
+
+	void assign(const Ref<NDArray>& out, const Variant& value);
+	void evaluate(const Ref<NDArray>& out, const String& expression, const Dictionary& variables);
+	void call_function(const Ref<NDArray>& out, const StringName& function, const Array& args);
+	void reduce(const Ref<NDArray>& out, const StringName& function, const Variant& a, const Variant& axes);
+
+	void run();
+	void clear();
+	[[nodiscard]] int64_t get_step_count() const;
+};
+
+#endif
@@ -6,7 +6,10 @@
 #include "godot_cpp/core/class_db.hpp"  // for GDREGISTER_CLASS
 #include "nd.h"                         // for nd
 #include "ndarray.h"                    // for NDArray
+#include "ndexpression.h"               // for NDExpression
+#include "ndprogram.h"                  // for NDProgram
 #include "ndrange.h"                    // for NDRange
+#include "vatensor/vparallel.h"         // for stop_threads
 
 using namespace godot;
 
@@ -18,12 +21,17 @@ void initialize_numdot_module(ModuleInitializationLevel p_level) {
 	GDREGISTER_CLASS(nd);
 	GDREGISTER_CLASS(NDArray);
 	GDREGISTER_CLASS(NDRange);
+	GDREGISTER_CLASS(NDExpression);
+	GDREGISTER_CLASS(NDProgram);
 }
 
 void uninitialize_numdot_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+
+	// Join worker threads while the library is still fully loaded.
+	va::parallel::stop_threads();
 }
 
 extern "C" {
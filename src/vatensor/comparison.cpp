@@ -9,80 +9,80 @@
 
 using namespace va;
 
-void va::equal_to(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::equal_to(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_in_bool_out>(
         va::XFunction<xt::detail::equal_to> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::not_equal_to(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::not_equal_to(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_in_bool_out>(
         va::XFunction<xt::detail::not_equal_to> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::greater(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::greater(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_num_in_x_out<bool>>(
         va::XFunction<xt::detail::greater> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::greater_equal(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::greater_equal(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_num_in_x_out<bool>>(
         va::XFunction<xt::detail::greater_equal> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::less(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::less(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_num_in_x_out<bool>>(
         va::XFunction<xt::detail::less> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::less_equal(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::less_equal(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_COMPARISON_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_COMPARISON_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_num_in_x_out<bool>>(
         va::XFunction<xt::detail::less_equal> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
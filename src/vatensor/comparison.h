@@ -5,12 +5,12 @@
 #include "varray.h"
 
 namespace va {
-    void equal_to(VArrayTarget target, const VArray& a, const VArray& b);
-    void not_equal_to(VArrayTarget target, const VArray& a, const VArray& b);
-    void greater(VArrayTarget target, const VArray& a, const VArray& b);
-    void greater_equal(VArrayTarget target, const VArray& a, const VArray& b);
-    void less(VArrayTarget target, const VArray& a, const VArray& b);
-    void less_equal(VArrayTarget target, const VArray& a, const VArray& b);
+    void equal_to(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void not_equal_to(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void greater(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void greater_equal(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void less(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void less_equal(VArrayTarget target, const VDataRef& a, const VDataRef& b);
 }
 
 #endif //COMPARISON_H
@@ -0,0 +1,284 @@
+#include "histogram.h"
+
+#include <algorithm>                                    // for fill_n, max, min, upper_bound
+#include <cmath>                                        // for double_t, isfinite
+#include <cstddef>                                      // for size_t, ptrdiff_t
+#include <cstdint>                                      // for int64_t
+#include <limits>                                       // for numeric_limits
+#include <optional>                                     // for optional
+#include <stdexcept>                                    // for runtime_error
+#include <type_traits>                                  // for decay_t, is_integral_v, is_signed_v
+#include <variant>                                      // for visit, get_if
+#include <vector>                                       // for vector
+#include "vcompute.h"                                   // for assign_to_target, evaluate_to_buffer
+#include "vparallel.h"                                  // for parallel_for, get_threshold, get_num_threads
+#include "xtensor/xlayout.hpp"                          // for layout_type
+
+using namespace va;
+
+namespace {
+	// Returns the elements in row major order, copying them to storage if they aren't contiguous.
+	template <typename T>
+	const T* contiguous_data(const compute_case<T>& carray, store_case<T>& storage) {
+		if (is_contiguous_in_order(carray.shape(), carray.strides(), xt::layout_type::row_major)) {
+			return carray.data();
+		}
+
+		storage = make_store<T>(shape_type(carray.shape().begin(), carray.shape().end()));
+		evaluate_to_buffer(storage->data(), carray.size(), carray.shape(), carray);
+		return storage->data();
+	}
+
+	// Copies the elements of the array to a new row major store of type T.
+	template <typename T>
+	store_case<T> copy_as(const VArray& array) {
+		auto store = make_store<T>(array.shape);
+		std::visit([&store](const auto& carray) {
+			evaluate_to_buffer(store->data(), carray.size(), carray.shape(), carray);
+		}, array.to_compute_variant());
+		return store;
+	}
+
+	template <typename T>
+	void assign_store(VArrayTarget target, const store_case<T>& store) {
+		if (const auto new_target = std::get_if<std::optional<VArray>*>(&target)) {
+			**new_target = from_store(store);
+		} else {
+			assign_to_target<T>(target, *store);
+		}
+	}
+
+	// Adds weight_of(i) to counts[bin_of(i)] for each of size elements, skipping those with a negative bin.
+	// Large inputs are split over the threads, each counting into a private histogram, and the histograms are summed
+	//  at the end. This avoids atomic increments, which would contend for the same few bins.
+	template <typename Count, typename BinOf, typename WeightOf>
+	void accumulate_bins(Count* counts, const std::size_t num_bins, const std::size_t size, const BinOf& bin_of, const WeightOf& weight_of) {
+		std::fill_n(counts, num_bins, Count(0));
+
+		const auto count_range = [&bin_of, &weight_of](Count* histogram, const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				const std::ptrdiff_t bin = bin_of(i);
+				if (bin >= 0) {
+					histogram[bin] += weight_of(i);
+				}
+			}
+		};
+
+		const std::size_t num_threads = parallel::get_num_threads();
+		// Summing the private histograms shouldn't cost more than counting.
+		if (size < parallel::get_threshold() || num_threads <= 1 || num_bins * num_threads > size) {
+			count_range(counts, 0, size);
+			return;
+		}
+
+		const std::size_t chunk_size = (size + num_threads - 1) / num_threads;
+		std::vector<Count> histograms(num_threads * num_bins, Count(0));
+
+		parallel::parallel_for(0, num_threads, 1, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t chunk = begin; chunk < end; ++chunk) {
+				const std::size_t chunk_begin = std::min(chunk * chunk_size, size);
+				count_range(histograms.data() + chunk * num_bins, chunk_begin, std::min(chunk_begin + chunk_size, size));
+			}
+		});
+
+		for (std::size_t chunk = 0; chunk < num_threads; ++chunk) {
+			const Count* histogram = histograms.data() + chunk * num_bins;
+			for (std::size_t bin = 0; bin < num_bins; ++bin) {
+				counts[bin] += histogram[bin];
+			}
+		}
+	}
+}
+
+void va::bincount(VArrayTarget target, const VArray& array, const std::optional<VArray>& weights, const std::size_t min_length) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	if (array.dimension() != 1) {
+		throw std::runtime_error("bincount needs a 1-D array.");
+	}
+
+	store_case<double_t> weights_store;
+	if (weights.has_value()) {
+		if (weights->size() != array.size()) {
+			throw std::runtime_error("The weights must have the same size as the array.");
+		}
+		weights_store = copy_as<double_t>(*weights);
+	}
+
+	std::visit([target, &weights_store, min_length](const auto& carray) {
+		using T = typename std::decay_t<decltype(carray)>::value_type;
+
+		if constexpr (!std::is_integral_v<T>) {
+			throw std::runtime_error("bincount needs an array of integers.");
+		} else {
+			store_case<T> storage;
+			const T* data = contiguous_data(carray, storage);
+			const std::size_t size = carray.size();
+
+			// Larger values could neither be binned with a ptrdiff_t, nor have their bins allocated.
+			constexpr auto max_value = static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(double_t) - 1;
+
+			std::size_t num_bins = min_length;
+			for (std::size_t i = 0; i < size; ++i) {
+				if constexpr (std::is_signed_v<T>) {
+					if (data[i] < 0) {
+						throw std::runtime_error("bincount needs non-negative integers.");
+					}
+				}
+				if constexpr (sizeof(T) >= sizeof(std::size_t)) {
+					if (static_cast<std::size_t>(data[i]) > max_value) {
+						throw std::runtime_error("bincount can't count values this large.");
+					}
+				}
+				num_bins = std::max(num_bins, static_cast<std::size_t>(data[i]) + 1);
+			}
+
+			const auto bin_of = [data](const std::size_t i) {
+				return static_cast<std::ptrdiff_t>(data[i]);
+			};
+
+			if (weights_store) {
+				const double_t* weight_data = weights_store->data();
+				auto store = make_store<double_t>(shape_type { num_bins });
+				accumulate_bins(store->data(), num_bins, size, bin_of, [weight_data](const std::size_t i) {
+					return weight_data[i];
+				});
+				assign_store(target, store);
+			} else {
+				auto store = make_store<int64_t>(shape_type { num_bins });
+				accumulate_bins(store->data(), num_bins, size, bin_of, [](std::size_t) {
+					return static_cast<int64_t>(1);
+				});
+				assign_store(target, store);
+			}
+		}
+	}, array.to_compute_variant());
+#endif
+}
+
+void va::histogram(VArrayTarget target, const VArray& array, const std::size_t num_bins, const std::optional<std::pair<double, double>>& range) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	if (num_bins == 0) {
+		throw std::runtime_error("The number of bins must be positive.");
+	}
+	if (range.has_value() && !(range->first <= range->second)) {
+		throw std::runtime_error("The range must be increasing.");
+	}
+	if (range.has_value() && !std::isfinite(range->second - range->first)) {
+		throw std::runtime_error("The range must be finite.");
+	}
+
+	std::visit([target, num_bins, &range](const auto& carray) {
+		using T = typename std::decay_t<decltype(carray)>::value_type;
+
+		store_case<T> storage;
+		const T* data = contiguous_data(carray, storage);
+		const std::size_t size = carray.size();
+
+		double min = 0;
+		double max = 1;
+		if (range.has_value()) {
+			min = range->first;
+			max = range->second;
+		} else {
+			bool is_first = true;
+			for (std::size_t i = 0; i < size; ++i) {
+				const auto value = static_cast<double>(data[i]);
+				if (value != value) {
+					continue;
+				}
+				min = is_first || value < min ? value : min;
+				max = is_first || value > max ? value : max;
+				is_first = false;
+			}
+			// Like numpy, empty arrays use the range [0, 1], but NaN values alone have no range.
+			if (is_first && size > 0) {
+				throw std::runtime_error("The autodetected range is not finite, because all values are NaN.");
+			}
+			// Bins of infinite width can't be scaled to.
+			if (!std::isfinite(max - min)) {
+				throw std::runtime_error("The range of an array with infinite values must be given explicitly.");
+			}
+		}
+		if (min == max) {
+			min -= 0.5;
+			max += 0.5;
+		}
+
+		// Bins are found by scaling, then corrected by comparing with the edges, which can be off due to rounding.
+		const double width = (max - min) / static_cast<double>(num_bins);
+		const double scale = static_cast<double>(num_bins) / (max - min);
+		const auto last_bin = static_cast<std::ptrdiff_t>(num_bins - 1);
+
+		const auto bin_of = [data, min, max, width, scale, last_bin](const std::size_t i) -> std::ptrdiff_t {
+			const auto value = static_cast<double>(data[i]);
+			if (!(value >= min && value <= max)) {
+				return -1;
+			}
+
+			std::ptrdiff_t bin = std::min(static_cast<std::ptrdiff_t>((value - min) * scale), last_bin);
+			if (bin > 0 && value < min + static_cast<double>(bin) * width) {
+				--bin;
+			} else if (bin < last_bin && value >= min + static_cast<double>(bin + 1) * width) {
+				++bin;
+			}
+			return bin;
+		};
+
+		auto store = make_store<int64_t>(shape_type { num_bins });
+		accumulate_bins(store->data(), num_bins, size, bin_of, [](std::size_t) {
+			return static_cast<int64_t>(1);
+		});
+		assign_store(target, store);
+	}, array.to_compute_variant());
+#endif
+}
+
+void va::histogram(VArrayTarget target, const VArray& array, const VArray& edges) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	if (edges.dimension() != 1 || edges.size() < 2) {
+		throw std::runtime_error("The bin edges must be a 1-D array of at least two elements.");
+	}
+
+	const auto edges_store = copy_as<double_t>(edges);
+	const double_t* edges_begin = edges_store->data();
+	const double_t* edges_end = edges_begin + edges_store->size();
+	for (const double_t* edge = edges_begin + 1; edge != edges_end; ++edge) {
+		if (!(*edge >= *(edge - 1))) {
+			throw std::runtime_error("The bin edges must be sorted in increasing order.");
+		}
+	}
+
+	std::visit([target, edges_begin, edges_end](const auto& carray) {
+		using T = typename std::decay_t<decltype(carray)>::value_type;
+
+		store_case<T> storage;
+		const T* data = contiguous_data(carray, storage);
+		const std::size_t num_bins = static_cast<std::size_t>(edges_end - edges_begin) - 1;
+		const double_t min = *edges_begin;
+		const double_t max = *(edges_end - 1);
+
+		const auto bin_of = [data, edges_begin, edges_end, min, max, num_bins](const std::size_t i) -> std::ptrdiff_t {
+			const auto value = static_cast<double_t>(data[i]);
+			if (!(value >= min && value <= max)) {
+				return -1;
+			}
+			if (value == max) {
+				return static_cast<std::ptrdiff_t>(num_bins - 1);
+			}
+			return std::upper_bound(edges_begin, edges_end, value) - edges_begin - 1;
+		};
+
+		auto store = make_store<int64_t>(shape_type { num_bins });
+		accumulate_bins(store->data(), num_bins, carray.size(), bin_of, [](std::size_t) {
+			return static_cast<int64_t>(1);
+		});
+		assign_store(target, store);
+	}, array.to_compute_variant());
+#endif
+}
@@ -0,0 +1,22 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "auto_defines.h"
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+#include <utility>   // for pair
+#include "varray.h"
+
+namespace va {
+    // Counts the occurrences of each non-negative integer in the 1-D array, or sums their weights if given.
+    // The result has at least min_length elements.
+    void bincount(VArrayTarget target, const VArray& array, const std::optional<VArray>& weights, std::size_t min_length);
+
+    // Counts the elements in num_bins equal bins over the range, or over [min, max] of the array if not given.
+    // Elements outside the range, and NaN, are not counted. The last bin includes the upper edge.
+    void histogram(VArrayTarget target, const VArray& array, std::size_t num_bins, const std::optional<std::pair<double, double>>& range);
+    // Counts the elements in the bins between the sorted edges.
+    void histogram(VArrayTarget target, const VArray& array, const VArray& edges);
+}
+
+#endif //HISTOGRAM_H
@@ -9,41 +9,41 @@
 
 using namespace va;
 
-void va::logical_and(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::logical_and(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_LOGICAL_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_LOGICAL_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::bool_in_bool_out>(
         XFunction<xt::detail::logical_and> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::logical_or(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::logical_or(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_LOGICAL_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_LOGICAL_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::bool_in_bool_out>(
         XFunction<xt::detail::logical_or> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::logical_xor(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::logical_xor(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_LOGICAL_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_LOGICAL_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::bool_in_bool_out>(
         XFunction<xt::detail::not_equal_to> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
@@ -5,9 +5,9 @@
 #include "varray.h"
 
 namespace va {
-    void logical_and(VArrayTarget target, const VArray& a, const VArray& b);
-    void logical_or(VArrayTarget target, const VArray& a, const VArray& b);
-    void logical_xor(VArrayTarget target, const VArray& a, const VArray& b);
+    void logical_and(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void logical_or(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void logical_xor(VArrayTarget target, const VDataRef& a, const VDataRef& b);
     void logical_not(VArrayTarget target, const VArray& a);
 }
 
@@ -1,15 +1,20 @@
 #include "reduce.h"
 
 #include <cmath>                                       // for double_t
+#include <cstdint>                                      // for int64_t
+#include <optional>                                     // for optional
+#include <stdexcept>                                    // for runtime_error
+#include <type_traits>                                  // for decay_t
 #include <utility>                                      // for forward
+#include <variant>                                      // for visit, get_if
 #include "vatensor/varray.h"                            // for VArray, Axes
 #include "vcompute.h"
 #include "vpromote.h"                                    // for promote
+#include "vreduce.h"                                     // for reduce_with, reduce_each, Sum, Prod, Mean, Variance, Std, Describe, All, Any, ArgMax, ArgMin, select_top_k
 #include "xtensor/xiterator.hpp"                        // for operator==
 #include "xtensor/xlayout.hpp"                          // for layout_type
 #include "xtensor/xmath.hpp"                            // for amax, amin, mean
 #include "xtensor/xnorm.hpp"                            // for norms
-#include "xtensor/xtensor_forward.hpp"                            // for xtensor_fixed
 #include "xtl/xiterator_base.hpp"                       // for operator!=
 
 using namespace va;
@@ -26,26 +31,6 @@ using namespace va;
 		return fun_name_no_axes(std::forward<A>(a), std::tuple<xt::evaluation_strategy::lazy_type>());\
 	}
 
-// To be able to use xt::all and xt::any, the second function needs special treatment.
-// For one, it can't get EVS as parameter.
-// Second, the return type is bool, so it needs to be converted to a temp tensor.
-#define ReducerAnyAll(Name, fun_name_axes, fun_name_no_axes)\
-	template <typename GivenAxes, typename A>\
-	auto operator()(GivenAxes&& axes, A&& a) const {\
-		return fun_name_axes(std::forward<A>(a), std::forward<GivenAxes>(axes), std::tuple<xt::evaluation_strategy::lazy_type>());\
-	}\
-\
-	template <typename A>\
-	auto operator()(A&& a) const {\
-		return xt::xtensor_fixed<bool, xshape<>>(fun_name_no_axes(std::forward<A>(a)));\
-	}
-
-struct Sum { Reducer(Sum, xt::sum, xt::sum) };
-struct Prod { Reducer(Prod, xt::prod, xt::prod) };
-struct Mean { Reducer(Mean, xt::mean, xt::mean) };
-struct Variance { Reducer(Variance, xt::variance, xt::variance) };
-struct Std { Reducer(Std, xt::stddev, xt::stddev) };
-
 struct Amax { Reducer(Amax, xt::amax, xt::amax) };
 struct Amin { Reducer(Amin, xt::amin, xt::amin) };
 
@@ -54,21 +39,11 @@ struct NormL1 { Reducer(NormL1, xt::norm_l1, xt::norm_l1) };
 struct NormL2 { Reducer(NormL2, xt::norm_l2, xt::norm_l2) };
 struct NormLInf { Reducer(NormLInf, xt::norm_linf, xt::norm_linf) };
 
-// FIXME These don't support axes yet, see https://github.com/xtensor-stack/xtensor/issues/1555
-using namespace xt;
-XTENSOR_REDUCER_FUNCTION(va_any, xt::detail::logical_or, bool, true)
-XTENSOR_REDUCER_FUNCTION(va_all, xt::detail::logical_and, bool, false)
-
-struct All { ReducerAnyAll(All, va_all, xt::all) };
-struct Any { ReducerAnyAll(Any, va_any, xt::any) };
-
 void va::sum(VArrayTarget target, const VArray& array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::num_common_type>(
-		Sum{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Sum, promote::num_common_type>(target, array, axes);
 #endif
 }
 
@@ -76,9 +51,7 @@ void va::prod(VArrayTarget target, const VArray& array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::num_common_at_least_int32>(
-		Prod{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Prod, promote::num_common_at_least_int32>(target, array, axes);
 #endif
 }
 
@@ -86,9 +59,7 @@ void va::mean(VArrayTarget target, const VArray& array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::num_matching_float_or_default<double_t>>(
-		Mean{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Mean, promote::num_matching_float_or_default<double_t>>(target, array, axes);
 #endif
 }
 
@@ -96,9 +67,7 @@ void va::var(VArrayTarget target, const VArray& array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::num_matching_float_or_default<double_t>>(
-		Variance{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Variance, promote::num_matching_float_or_default<double_t>>(target, array, axes);
 #endif
 }
 
@@ -106,9 +75,7 @@ void va::std(VArrayTarget target, const VArray& array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::num_matching_float_or_default<double_t>>(
-		Std{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Std, promote::num_matching_float_or_default<double_t>>(target, array, axes);
 #endif
 }
 
@@ -132,6 +99,89 @@ void va::min(VArrayTarget target, const VArray& array, const Axes &axes) {
 #endif
 }
 
+va::VMoments va::moments(const VArray& array, const Axes& axes) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	const shape_type normalized_axes = reduce::normalize_axes(axes, array.dimension());
+
+	return std::visit([&normalized_axes](const auto& carray) -> VMoments {
+		using T = typename std::decay_t<decltype(carray)>::value_type;
+		using Acc = reduce::Describe::accumulator<T>;
+		using M = typename Acc::min_type;
+		using F = typename Acc::float_type;
+
+		const reduce::ReductionLayout layout(carray.shape(), carray.strides(), normalized_axes);
+		auto min = make_store<M>(layout.kept_shape);
+		auto max = make_store<M>(layout.kept_shape);
+		auto mean = make_store<F>(layout.kept_shape);
+		auto variance = make_store<F>(layout.kept_shape);
+
+		if (layout.count == 0 && min->size() > 0) {
+			throw std::runtime_error("Cannot compute the moments of zero elements.");
+		}
+
+		M* min_data = min->data();
+		M* max_data = max->data();
+		F* mean_data = mean->data();
+		F* variance_data = variance->data();
+		reduce::reduce_each<reduce::Describe, T>(carray, layout, [=](const std::size_t i, const Acc& acc) {
+			min_data[i] = acc.min;
+			max_data[i] = acc.max;
+			mean_data[i] = acc.moments.mean;
+			variance_data[i] = acc.moments.m2 / static_cast<F>(acc.moments.count);
+		});
+
+		return { layout.count, from_store(min), from_store(max), from_store(mean), from_store(variance) };
+	}, array.to_compute_variant());
+#endif
+}
+
+void va::argmax(VArrayTarget target, const VArray& array, const Axes& axes) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	reduce::reduce_with<reduce::ArgMax, promote::common_num_in_x_out<int64_t>>(target, array, axes);
+#endif
+}
+
+void va::argmin(VArrayTarget target, const VArray& array, const Axes& axes) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	reduce::reduce_with<reduce::ArgMin, promote::common_num_in_x_out<int64_t>>(target, array, axes);
+#endif
+}
+
+void va::top_k(VArrayTarget target, const VArray& array, const std::size_t k, const std::ptrdiff_t axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	const auto dimension = static_cast<std::ptrdiff_t>(array.dimension());
+	const std::ptrdiff_t normalized_axis = axis < 0 ? axis + dimension : axis;
+	if (normalized_axis < 0 || normalized_axis >= dimension) {
+		throw std::runtime_error("Axis out of bounds.");
+	}
+	if (k > array.shape[normalized_axis]) {
+		throw std::runtime_error("k is larger than the size of the axis.");
+	}
+
+	std::visit([target, k, normalized_axis](const auto& carray) {
+		shape_type shape(carray.shape().begin(), carray.shape().end());
+		shape[normalized_axis] = k;
+		const auto store = make_store<int64_t>(shape);
+
+		reduce::select_top_k(store->data(), store->strides(), carray, k, static_cast<std::size_t>(normalized_axis));
+
+		if (const auto new_target = std::get_if<std::optional<VArray>*>(&target)) {
+			**new_target = from_store(store);
+		} else {
+			assign_to_target<int64_t>(target, *store);
+		}
+	}, array.to_compute_variant());
+#endif
+}
+
 void va::norm_l0(VArrayTarget target, const VArray &array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
@@ -176,9 +226,7 @@ void va::all(VArrayTarget target, const VArray &array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::bool_in_bool_out>(
-		All{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::All, promote::bool_in_bool_out>(target, array, axes);
 #endif
 }
 
@@ -186,8 +234,6 @@ void va::any(VArrayTarget target, const VArray &array, const Axes &axes) {
 #ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
 	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
 #else
-	va::xreduction_inplace<promote::bool_in_bool_out>(
-		Any{}, axes, target, array.to_compute_variant()
-	);
+	reduce::reduce_with<reduce::Any, promote::bool_in_bool_out>(target, array, axes);
 #endif
 }
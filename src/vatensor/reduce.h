@@ -2,9 +2,20 @@
 #define REDUCE_H
 
 #include "auto_defines.h"
+#include <cstddef>   // for size_t, ptrdiff_t
 #include "varray.h"
 
 namespace va {
+    // Statistics of an array along some axes, see moments().
+    struct VMoments {
+        // Number of elements reduced into each output.
+        std::size_t count;
+        VArray min;
+        VArray max;
+        VArray mean;
+        VArray variance;
+    };
+
     void sum(VArrayTarget target, const VArray& array, const Axes& axes);
     void prod(VArrayTarget target, const VArray& array, const Axes& axes);
     void mean(VArrayTarget target, const VArray& array, const Axes& axes);
@@ -12,6 +23,14 @@ namespace va {
     void std(VArrayTarget target, const VArray& array, const Axes& axes);
     void max(VArrayTarget target, const VArray& array, const Axes& axes);
     void min(VArrayTarget target, const VArray& array, const Axes& axes);
+    // Computes min, max, mean and variance in a single pass over the array.
+    VMoments moments(const VArray& array, const Axes& axes);
+
+    // Indices are flat over the reduced axes, in C order.
+    void argmax(VArrayTarget target, const VArray& array, const Axes& axes);
+    void argmin(VArrayTarget target, const VArray& array, const Axes& axes);
+    // Indices of the k largest elements along the axis, from largest to smallest.
+    void top_k(VArrayTarget target, const VArray& array, std::size_t k, std::ptrdiff_t axis);
 
     void norm_l0(VArrayTarget target, const VArray& array, const Axes& axes);
     void norm_l1(VArrayTarget target, const VArray& array, const Axes& axes);
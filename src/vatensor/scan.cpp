@@ -0,0 +1,298 @@
+#include "scan.h"
+
+#include <algorithm>                                    // for equal, max, min
+#include <cstddef>                                      // for size_t, ptrdiff_t
+#include <memory>                                       // for unique_ptr
+#include <optional>                                     // for optional
+#include <stdexcept>                                    // for runtime_error
+#include <type_traits>                                  // for decay_t
+#include <variant>                                      // for visit, get_if
+#include "vcompute.h"                                   // for assign_to_target, evaluate_to_buffer, may_alias
+#include "vparallel.h"                                  // for parallel_for, get_threshold, get_num_threads
+#include "vpromote.h"                                   // for num_common_type, num_common_at_least_int32
+#include "vreduce.h"                                    // for normalize_axes, is_nan
+#include "xtensor/xlayout.hpp"                          // for layout_type
+
+using namespace va;
+
+namespace {
+	struct CumSum {
+		template <typename T>
+		static T apply(const T acc, const T value) {
+			return acc + value;
+		}
+	};
+
+	struct CumProd {
+		template <typename T>
+		static T apply(const T acc, const T value) {
+			return acc * value;
+		}
+	};
+
+	// NaN propagates, like in NumPy.
+	struct CumMax {
+		template <typename T>
+		static T apply(const T acc, const T value) {
+			return reduce::is_nan(acc) || acc > value ? acc : value;
+		}
+	};
+
+	// Combines all elements of a contiguous range, in 8 independent lanes so the compiler can vectorize it.
+	// size must be at least 1.
+	template <typename Op, typename O, typename T>
+	O fold(const T* in, const std::size_t size) {
+		constexpr std::size_t lanes = 8;
+
+		std::size_t i = 1;
+		O acc = static_cast<O>(in[0]);
+		if (size >= lanes) {
+			O lane[lanes];
+			for (std::size_t j = 0; j < lanes; ++j) {
+				lane[j] = static_cast<O>(in[j]);
+			}
+			for (i = lanes; i + lanes <= size; i += lanes) {
+				for (std::size_t j = 0; j < lanes; ++j) {
+					lane[j] = Op::apply(lane[j], static_cast<O>(in[i + j]));
+				}
+			}
+
+			acc = lane[0];
+			for (std::size_t j = 1; j < lanes; ++j) {
+				acc = Op::apply(acc, lane[j]);
+			}
+		}
+
+		for (; i < size; ++i) {
+			acc = Op::apply(acc, static_cast<O>(in[i]));
+		}
+		return acc;
+	}
+
+	// Scans a contiguous line, continuing from carry if given. in may be the same as out.
+	template <typename Op, typename O, typename T>
+	void scan_line(O* out, const T* in, const std::size_t size, const O* carry) {
+		if (size == 0) {
+			return;
+		}
+
+		O acc = carry ? Op::apply(*carry, static_cast<O>(in[0])) : static_cast<O>(in[0]);
+		out[0] = acc;
+		for (std::size_t i = 1; i < size; ++i) {
+			acc = Op::apply(acc, static_cast<O>(in[i]));
+			out[i] = acc;
+		}
+	}
+
+	// Lines longer than this are scanned in chunks of this many elements, each continuing from the fold of all chunks
+	//  before it, so long lines can be split over the threads. The chunks don't depend on the number of threads, so
+	//  floating point results are the same on every machine.
+	constexpr std::size_t line_chunk_size = 1 << 14;
+
+	// Scans a contiguous line like scan_block does on one thread. in may be the same as out.
+	template <typename Op, typename O, typename T>
+	void scan_chunked_line(O* out, const T* in, const std::size_t size) {
+		O running {};
+		for (std::size_t chunk_begin = 0; chunk_begin < size; chunk_begin += line_chunk_size) {
+			const std::size_t chunk_size = std::min(line_chunk_size, size - chunk_begin);
+			const bool is_last = chunk_begin + chunk_size == size;
+
+			// Fold before scanning, because in may be overwritten. The chunk stays in cache for the scan.
+			O own {};
+			if (!is_last) {
+				own = fold<Op, O>(in + chunk_begin, chunk_size);
+			}
+			scan_line<Op>(out + chunk_begin, in + chunk_begin, chunk_size, chunk_begin == 0 ? nullptr : &running);
+			if (!is_last) {
+				running = chunk_begin == 0 ? own : Op::apply(running, own);
+			}
+		}
+	}
+
+	// Scans the contiguous block in[outer][size][inner] along the middle dimension, into out with the same layout.
+	// in may be the same as out.
+	template <typename Op, typename O, typename T>
+	void scan_block(O* out, const T* in, const std::size_t outer, const std::size_t size, const std::size_t inner) {
+		const std::size_t total = outer * size * inner;
+		if (total == 0) {
+			return;
+		}
+
+		const std::size_t num_threads = parallel::get_num_threads();
+		const bool is_large = total >= parallel::get_threshold() && num_threads > 1;
+
+		if (inner == 1 && outer == 1 && is_large && size > line_chunk_size) {
+			// One long line, in two passes: fold each chunk in parallel, then scan each chunk in parallel,
+			//  continuing from the fold of all chunks before it. This computes the same as scan_chunked_line.
+			const std::size_t num_chunks = (size + line_chunk_size - 1) / line_chunk_size;
+			const std::unique_ptr<O[]> carries(new O[num_chunks]);
+
+			parallel::parallel_for(0, num_chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+				for (std::size_t chunk = begin; chunk < end; ++chunk) {
+					const std::size_t chunk_begin = chunk * line_chunk_size;
+					carries[chunk] = fold<Op, O>(in + chunk_begin, std::min(line_chunk_size, size - chunk_begin));
+				}
+			});
+
+			O running = carries[0];
+			for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+				const O own = carries[chunk];
+				carries[chunk] = running;
+				running = Op::apply(running, own);
+			}
+
+			parallel::parallel_for(0, num_chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+				for (std::size_t chunk = begin; chunk < end; ++chunk) {
+					const std::size_t chunk_begin = chunk * line_chunk_size;
+					scan_line<Op>(
+						out + chunk_begin, in + chunk_begin, std::min(line_chunk_size, size - chunk_begin),
+						chunk == 0 ? nullptr : &carries[chunk]
+					);
+				}
+			});
+			return;
+		}
+
+		if (inner == 1) {
+			const auto scan_lines = [&](const std::size_t begin, const std::size_t end) {
+				for (std::size_t line = begin; line < end; ++line) {
+					scan_chunked_line<Op>(out + line * size, in + line * size, size);
+				}
+			};
+
+			if (is_large && outer > 1) {
+				parallel::parallel_for(0, outer, std::max(outer / (num_threads * 4), static_cast<std::size_t>(1)), scan_lines);
+			} else {
+				scan_lines(0, outer);
+			}
+			return;
+		}
+
+		// The axis isn't the last one, so each row is combined with the previous row of results, which vectorizes.
+		// Rows are split into blocks of columns, so that wide rows can be spread over the threads too.
+		constexpr std::size_t column_block_size = 1024;
+		const std::size_t blocks_per_outer = (inner + column_block_size - 1) / column_block_size;
+		const std::size_t num_tasks = outer * blocks_per_outer;
+
+		const auto scan_columns = [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t task = begin; task < end; ++task) {
+				const std::size_t offset = task / blocks_per_outer * size * inner;
+				const std::size_t column_begin = task % blocks_per_outer * column_block_size;
+				const std::size_t column_end = std::min(column_begin + column_block_size, inner);
+				O* out_block = out + offset;
+				const T* in_block = in + offset;
+
+				for (std::size_t j = column_begin; j < column_end; ++j) {
+					out_block[j] = static_cast<O>(in_block[j]);
+				}
+				for (std::size_t i = 1; i < size; ++i) {
+					O* row = out_block + i * inner;
+					const O* previous = row - inner;
+					const T* in_row = in_block + i * inner;
+					for (std::size_t j = column_begin; j < column_end; ++j) {
+						row[j] = Op::apply(previous[j], static_cast<O>(in_row[j]));
+					}
+				}
+			}
+		};
+
+		if (is_large && num_tasks > 1) {
+			parallel::parallel_for(0, num_tasks, 1, scan_columns);
+		} else {
+			scan_columns(0, num_tasks);
+		}
+	}
+
+	template <typename Op, typename PromotionRule>
+	void scan(VArrayTarget target, const VArray& array, const Axes& axes) {
+		std::optional<std::size_t> axis;
+		if (const auto given_axes = std::get_if<GivenAxes>(&axes)) {
+			if (given_axes->size() != 1) {
+				throw std::runtime_error("Cumulative functions need exactly one axis, or none.");
+			}
+			axis = reduce::normalize_axes(axes, array.dimension())[0];
+		}
+
+		std::visit([target, axis](const auto& carray) {
+			using T = typename std::decay_t<decltype(carray)>::value_type;
+			using InputType = typename PromotionRule::template input_type<T>;
+			using OutputType = typename PromotionRule::template output_type<InputType>;
+
+			const auto& array_shape = carray.shape();
+			const shape_type shape = axis ? shape_type(array_shape.begin(), array_shape.end()) : shape_type { carray.size() };
+			const std::size_t scan_axis = axis.value_or(0);
+
+			std::size_t outer = 1;
+			std::size_t inner = 1;
+			for (std::size_t d = 0; d < shape.size(); ++d) {
+				if (d < scan_axis) {
+					outer *= shape[d];
+				} else if (d > scan_axis) {
+					inner *= shape[d];
+				}
+			}
+
+			// Write straight to the target if it has the right dtype and layout, e.g. when scanning in place.
+			OutputType* output = nullptr;
+			if (const auto compute_target = std::get_if<ComputeVariant*>(&target)) {
+				if (const auto ctarget = std::get_if<compute_case<OutputType>>(*compute_target)) {
+					if (
+						std::equal(shape.begin(), shape.end(), ctarget->shape().begin(), ctarget->shape().end())
+						&& is_contiguous_in_order(ctarget->shape(), ctarget->strides(), xt::layout_type::row_major)
+						&& !may_alias(*ctarget, carray)
+					) {
+						output = ctarget->data();
+					}
+				}
+			}
+
+			store_case<OutputType> store;
+			if (output == nullptr) {
+				store = make_store<OutputType>(shape);
+				output = store->data();
+			}
+
+			if (is_contiguous_in_order(array_shape, carray.strides(), xt::layout_type::row_major)) {
+				scan_block<Op>(output, carray.data(), outer, shape[scan_axis], inner);
+			} else {
+				// Gather the elements in order first, then scan them in place.
+				evaluate_to_buffer(output, carray.size(), array_shape, carray);
+				scan_block<Op>(output, static_cast<const OutputType*>(output), outer, shape[scan_axis], inner);
+			}
+
+			if (store == nullptr) {
+				return;
+			}
+
+			if (const auto new_target = std::get_if<std::optional<VArray>*>(&target)) {
+				**new_target = from_store(store);
+			} else {
+				assign_to_target<OutputType>(target, *store);
+			}
+		}, array.to_compute_variant());
+	}
+}
+
+void va::cumsum(VArrayTarget target, const VArray& array, const Axes& axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	scan<CumSum, promote::num_common_type>(target, array, axis);
+#endif
+}
+
+void va::cumprod(VArrayTarget target, const VArray& array, const Axes& axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	scan<CumProd, promote::num_common_at_least_int32>(target, array, axis);
+#endif
+}
+
+void va::cummax(VArrayTarget target, const VArray& array, const Axes& axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	scan<CumMax, promote::num_common_type>(target, array, axis);
+#endif
+}
@@ -0,0 +1,14 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "auto_defines.h"
+#include "varray.h"
+
+namespace va {
+    // Cumulative functions along one axis. Without an axis, the array is scanned flat, and the result is 1-D.
+    void cumsum(VArrayTarget target, const VArray& array, const Axes& axis);
+    void cumprod(VArrayTarget target, const VArray& array, const Axes& axis);
+    void cummax(VArrayTarget target, const VArray& array, const Axes& axis);
+}
+
+#endif //SCAN_H
@@ -82,15 +82,15 @@ void va::atan(VArrayTarget target, const VArray& array) {
 #endif
 }
 
-void va::atan2(VArrayTarget target, const VArray& x1, const VArray& x2) {
+void va::atan2(VArrayTarget target, const VDataRef& x1, const VDataRef& x2) {
 #ifdef NUMDOT_DISABLE_TRIGONOMETRY_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_TRIGONOMETRY_FUNCTIONS to enable it.");
 #else
     xoperation_inplace<promote::num_function_result<xt::math::atan2_fun>>(
         va::XFunction<xt::math::atan2_fun> {},
         target,
-        x1.to_compute_variant(),
-        x2.to_compute_variant()
+        x1,
+        x2
     );
 #endif
 }
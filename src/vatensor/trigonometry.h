@@ -12,7 +12,7 @@ namespace va {
     void asin(VArrayTarget target, const VArray& array);
     void acos(VArrayTarget target, const VArray& array);
     void atan(VArrayTarget target, const VArray& array);
-    void atan2(VArrayTarget target, const VArray& x1, const VArray& x2);
+    void atan2(VArrayTarget target, const VDataRef& x1, const VDataRef& x2);
 
     void sinh(VArrayTarget target, const VArray& array);
     void cosh(VArrayTarget target, const VArray& array);
@@ -1,25 +1,50 @@
 #include "varray.h"
 
-#include <cstddef>                         // for size_t
+#include <algorithm>                       // for equal, fill_n
+#include <cstddef>                         // for size_t, ptrdiff_t
+#include <cstring>                         // for memmove
+#include <functional>                      // for multiplies
+#include <numeric>                         // for accumulate
 #include <stdexcept>                       // for runtime_error
 #include <type_traits>                     // for decay_t
-#include "xtensor/xoperation.hpp"          // for cast
+#include <utility>                         // for move
+#include "vcompute.h"                      // for may_alias, broadcast_strides, strided_copy
 #include "xtensor/xstrided_view_base.hpp"  // for strided_view_args
 
+va::VArray::VArray(StoreVariant store, shape_type shape, strides_type strides, const size_type offset, const xt::layout_type layout)
+    : store(std::move(store)), shape(std::move(shape)), strides(std::move(strides)), offset(offset), layout(layout) {
+    size_ = std::accumulate(this->shape.begin(), this->shape.end(), static_cast<size_type>(1), std::multiplies());
+
+    if (size_ == 0 || is_contiguous_in_order(this->shape, this->strides, xt::layout_type::row_major)) {
+        contiguity_ = xt::layout_type::row_major;
+    }
+    else if (is_contiguous_in_order(this->shape, this->strides, xt::layout_type::column_major)) {
+        contiguity_ = xt::layout_type::column_major;
+    }
+
+    compute_variant_ = std::visit([this](const auto& store) -> ComputeVariant {
+        return va::to_compute_variant(store, *this);
+    }, this->store);
+}
+
 va::DType va::VArray::dtype() const {
     return DType(store.index());
 }
 
 size_t va::VArray::size() const {
-    return std::visit([](auto&& carray) { return carray.size(); }, to_compute_variant());
+    return size_;
 }
 
 size_t va::VArray::dimension() const {
-    return std::visit([](auto&& carray) { return carray.dimension(); }, to_compute_variant());
+    return shape.size();
+}
+
+xt::layout_type va::VArray::contiguity() const {
+    return contiguity_;
 }
 
 va::VArray va::VArray::slice(const xt::xstrided_slice_vector &slices) const {
-    return std::visit([slices, this](auto &store) -> VArray {
+    return std::visit([&slices, this](auto &store) -> VArray {
         xt::detail::strided_view_args<xt::detail::no_adj_strides_policy> args;
         args.fill_args(
             shape,
@@ -41,33 +66,95 @@ va::VArray va::VArray::slice(const xt::xstrided_slice_vector &slices) const {
     }, store);
 }
 
-void va::VArray::fill(VConstant value) const {
+void va::VArray::fill(VConstant value) {
     return std::visit([](auto&& carray, auto value) {
         // Cast first to reduce number of combinations down the line.
         using T = typename std::decay_t<decltype(carray)>::value_type;
-        carray.fill(static_cast<T>(value));
-    }, to_compute_variant(), value);
+        const T cast_value = static_cast<T>(value);
+
+        if (is_contiguous_in_order(carray.shape(), carray.strides(), xt::layout_type::row_major)) {
+            std::fill_n(carray.data(), carray.size(), cast_value);
+        } else {
+            // Slices are not contiguous, so the buffer can't be filled linearly.
+            const strides_type value_strides(carray.dimension(), 0);
+            strided_copy(carray.data(), carray.strides(), &cast_value, value_strides, carray.shape());
+        }
+    }, compute_variant_for_write(), value);
 }
 
-void va::VArray::set_with_array(const VArray& value) const {
-    return std::visit([](auto&& carray, auto&& cvalue) {
+void va::VArray::set_with_array(const VArray& value) {
+    return std::visit([](auto&& carray, const auto& cvalue) {
         using T = typename std::decay_t<decltype(carray)>::value_type;
-        // Cast first to reduce number of combinations down the line.
-        carray.computed_assign(xt::cast<T>(std::forward<decltype(cvalue)>(cvalue)));
-    }, to_compute_variant(), value.to_compute_variant());
+        using V = typename std::decay_t<decltype(cvalue)>::value_type;
+
+        const strides_type value_strides = broadcast_strides(carray.shape(), cvalue.shape(), cvalue.strides());
+
+        if constexpr (std::is_same_v<T, V>) {
+            if (
+                std::equal(carray.shape().begin(), carray.shape().end(), cvalue.shape().begin(), cvalue.shape().end())
+                && is_contiguous_in_order(carray.shape(), carray.strides(), xt::layout_type::row_major)
+                && is_contiguous_in_order(cvalue.shape(), cvalue.strides(), xt::layout_type::row_major)
+            ) {
+                // memmove, because the value may overlap the target.
+                std::memmove(carray.data(), cvalue.data(), carray.size() * sizeof(T));
+                return;
+            }
+        }
+
+        if (may_alias(carray, cvalue)) {
+            // Copy the value first, so that elements aren't overwritten before they are read.
+            const array_case<V> copy = cvalue;
+            const strides_type copy_strides = broadcast_strides(carray.shape(), copy.shape(), copy.strides());
+            strided_copy(carray.data(), carray.strides(), copy.data(), copy_strides, carray.shape());
+            return;
+        }
+
+        strided_copy(carray.data(), carray.strides(), cvalue.data(), value_strides, carray.shape());
+    }, compute_variant_for_write(), value.to_compute_variant());
 }
 
-va::ComputeVariant va::VArray::to_compute_variant() const {
-    return std::visit([this](const auto& store) -> ComputeVariant {
-        return va::to_compute_variant(store, *this);
-    }, store);
+void va::VArray::set_single_value(const strides_type& index, const VConstant value) {
+    if (index.size() != dimension()) {
+        throw std::runtime_error("The index needs one entry per dimension.");
+    }
+
+    std::visit([&index](auto&& carray, const auto value) {
+        using T = typename std::decay_t<decltype(carray)>::value_type;
+
+        std::ptrdiff_t offset = 0;
+        for (std::size_t i = 0; i < index.size(); ++i) {
+            const auto size = static_cast<std::ptrdiff_t>(carray.shape()[i]);
+            // Negative indices count from the end.
+            const std::ptrdiff_t position = index[i] < 0 ? index[i] + size : index[i];
+            if (position < 0 || position >= size) {
+                throw std::runtime_error("Index out of bounds.");
+            }
+            offset += position * carray.strides()[i];
+        }
+
+        carray.data()[offset] = static_cast<T>(value);
+    }, compute_variant_for_write(), value);
+}
+
+const va::ComputeVariant& va::VArray::to_compute_variant() const {
+    if (!compute_variant_.has_value()) {
+        throw std::runtime_error("The array has no store.");
+    }
+    return *compute_variant_;
+}
+
+va::ComputeVariant& va::VArray::compute_variant_for_write() {
+    if (!compute_variant_.has_value()) {
+        throw std::runtime_error("The array has no store.");
+    }
+    return *compute_variant_;
 }
 
 size_t va::VArray::size_of_array_in_bytes() const {
-    return std::visit([](auto&& carray){
-        using V = typename std::decay_t<decltype(carray)>::value_type;
-        return carray.size() * sizeof(V);
-    }, to_compute_variant());
+    return std::visit([this](const auto& store){
+        using V = typename std::decay_t<decltype(*store)>::value_type;
+        return size_ * sizeof(V);
+    }, store);
 }
 
 va::VConstant va::dtype_to_variant(DType dtype) {
@@ -93,7 +180,7 @@ va::VConstant va::dtype_to_variant(DType dtype) {
         case DType::UInt32:
             return uint32_t();
         case DType::UInt64:
-            return int64_t();
+            return uint64_t();
         default:
             throw std::runtime_error("Invalid dtype.");
     }
@@ -4,10 +4,10 @@
 #include <cmath>                        // for double_t, float_t
 #include <cstddef>                      // for size_t, ptrdiff_t, nullptr_t
 #include <cstdint>                      // for int16_t, int32_t, int64_t
-#include <functional>                   // for multiplies
+#include <functional>                   // for reference_wrapper, cref
 #include <memory>                       // for shared_ptr
-#include <numeric>                      // for accumulate
 #include <optional>                     // for optional
+#include <type_traits>                  // for is_same_v, decay_t
 #include <utility>                      // for move, forward
 #include <variant>                      // for variant, visit
 #include <vector>                       // for vector
@@ -18,6 +18,19 @@
 #include "xtensor/xshape.hpp"           // for dynamic_shape
 #include "xtensor/xstrided_view.hpp"    // for strided_view, xstrided_slice_...
 #include "xtensor/xtensor_forward.hpp"  // for xarray
+#include "xtensor/xtensor_simd.hpp"     // for aligned_mode
+#include "vpool.h"                      // for pool_allocator
+
+#ifdef XTENSOR_USE_XSIMD
+// Pool blocks are aligned, so xtensor can use aligned loads and stores on array_case buffers.
+namespace xsimd {
+    template <typename T>
+    struct allocator_alignment<va::pool_allocator<T>> {
+        static_assert(va::pool::alignment >= XSIMD_DEFAULT_ALIGNMENT);
+        using type = aligned_mode;
+    };
+}
+#endif
 
 namespace va {
     using shape_type = xt::dynamic_shape<std::size_t>;
@@ -61,7 +74,7 @@ namespace va {
     >;
 
     template <typename T>
-    using array_case = xt::xarray<T>;
+    using array_case = xt::xarray<T, XTENSOR_DEFAULT_LAYOUT, pool_allocator<T>>;
 
     // P&& pointer, typename A::size_type size, O ownership, SC&& shape, SS&& strides, const A& alloc = A()
     template <typename T>
@@ -98,27 +111,77 @@ namespace va {
         store_case<uint64_t>
     >;
 
+    // Allocates the store and its shared_ptr control block through the pool, so temporaries recycle memory.
+    template <typename T, typename... Args>
+    store_case<T> make_store(Args&&... args) {
+        return std::allocate_shared<array_case<T>>(pool_allocator<array_case<T>>(), std::forward<Args>(args)...);
+    }
+
+    // Returns true if the elements are laid out without gaps, in the given order (row_major or column_major).
+    template <typename Shape, typename Strides>
+    bool is_contiguous_in_order(const Shape& shape, const Strides& strides, const xt::layout_type order) {
+        const bool reverse = order == xt::layout_type::row_major;
+        std::ptrdiff_t expected_stride = 1;
+
+        for (std::size_t i = 0; i < shape.size(); ++i) {
+            const std::size_t dim = reverse ? shape.size() - 1 - i : i;
+
+            // Dimensions of size 1 can have any stride (xtensor uses 0).
+            if (shape[dim] == 1) {
+                continue;
+            }
+            if (strides[dim] != expected_stride) {
+                return false;
+            }
+            expected_stride *= static_cast<std::ptrdiff_t>(shape[dim]);
+        }
+
+        return true;
+    }
+
     class VArray {
     public:
+        // Don't modify these after construction; the metadata and adaptor below are derived from them.
+        // To view the store differently, construct a new VArray, like slice() does.
         StoreVariant store;
         shape_type shape;
         strides_type strides;
         size_type offset;
         xt::layout_type layout;
 
+        VArray() = default;
+        VArray(StoreVariant store, shape_type shape, strides_type strides, size_type offset, xt::layout_type layout);
+
         [[nodiscard]] DType dtype() const;
         [[nodiscard]] size_t size() const;
         [[nodiscard]] size_t dimension() const;
+        // row_major or column_major if the elements are contiguous in memory (in that order), dynamic otherwise.
+        [[nodiscard]] xt::layout_type contiguity() const;
 
         // TODO Can probably change these to subscript syntax
         [[nodiscard]] VArray slice(const xt::xstrided_slice_vector& slices) const;
-        void fill(VConstant value) const;
-        void set_with_array(const VArray& value) const;
+        void fill(VConstant value);
+        // Broadcasts and casts the value to this array's shape and dtype.
+        void set_with_array(const VArray& value);
+        // Writes a single element. The index has one (possibly negative) entry per dimension.
+        void set_single_value(const strides_type& index, VConstant value);
 
-        [[nodiscard]] ComputeVariant to_compute_variant() const;
+        // The adaptor is created on construction, and re-used for all later computations on this array.
+        // It is never modified afterwards, so it can be read from multiple threads at once.
+        [[nodiscard]] const ComputeVariant& to_compute_variant() const;
+        // The same adaptor, as a target for writing this array's elements.
+        // Functions writing to it must only write through its data: resizing or re-striding it would change this
+        //  array's view of its store for all later computations. assign_to_target guarantees this.
+        [[nodiscard]] ComputeVariant& compute_variant_for_write();
         [[nodiscard]] size_t size_of_array_in_bytes() const;
 
         [[nodiscard]] VConstant to_single_value() const;
+
+    private:
+        size_type size_ = 0;
+        xt::layout_type contiguity_ = xt::layout_type::dynamic;
+        // Empty only for default constructed arrays, which have no store.
+        std::optional<ComputeVariant> compute_variant_;
     };
 
     // For all functions returning an or assigning to an array.
@@ -126,14 +189,27 @@ namespace va {
     // The second case will assign to the compute variant.
     using VArrayTarget = std::variant<std::optional<VArray>*, ComputeVariant*>;
 
+    // Arguments to element-wise functions can be arrays or scalars.
+    // Scalars are broadcast by the kernel directly, which avoids allocating (and broadcasting) a 0-d array for them.
+    using VData = std::variant<VArray, VConstant>;
+    // The same, referencing arrays instead of copying their shape, strides and adaptor.
+    // Element-wise functions take their arguments this way; the arrays only need to outlive the call.
+    using VDataRef = std::variant<std::reference_wrapper<const VArray>, VConstant>;
+
+    inline VDataRef to_data_ref(const VData& data) {
+        return std::visit([](const auto& data) -> VDataRef {
+            if constexpr (std::is_same_v<std::decay_t<decltype(data)>, VArray>) {
+                return std::cref(data);
+            } else {
+                return data;
+            }
+        }, data);
+    }
+
     template <typename T>
     static auto to_compute_variant(const store_case<T>& store, const VArray& varray) {
-        auto shape = varray.shape;
-        auto strides = varray.strides;
-        auto size_ = std::accumulate(shape.begin(), shape.end(), static_cast<size_t>(1), std::multiplies());
-
         // return xt::adapt(store->data(), store->size(), xt::no_ownership(), store->shape(), store->strides());
-        return xt::adapt(store->data() + varray.offset, size_, xt::no_ownership(), shape, strides);
+        return xt::adapt(store->data() + varray.offset, varray.size(), xt::no_ownership(), varray.shape, varray.strides);
     }
 
     template <typename T>
@@ -1,8 +1,26 @@
 #ifndef VCOMPUTE_INPLACE_H
 #define VCOMPUTE_INPLACE_H
 
+#include <algorithm>               // for copy, equal, find, max, min, transform
+#include <array>                   // for array
+#include <cstddef>                 // for size_t, ptrdiff_t
+#include <cstdint>                 // for uint64_t, uintptr_t
+#include <functional>              // for multiplies, reference_wrapper
+#include <numeric>                 // for accumulate
+#include <optional>                // for optional
+#include <stdexcept>               // for runtime_error
+#include <tuple>                   // for make_tuple, apply
+#include <type_traits>             // for is_same_v, is_arithmetic_v, decay_t, true_type, false_type
+#include <utility>                 // for pair, forward
 #include "varray.h"
+#include "vcpu.h"
+#include "vparallel.h"
+#include "vpool.h"
 #include "vpromote.h"
+#include "xtensor/xadapt.hpp"      // for adapt
+#include "xtensor/xnoalias.hpp"    // for noalias
+#include "xtensor/xoperation.hpp"  // for plus, minus, multiplies, divides, equal_to, less, logical_and
+#include "xtensor/xtensor_simd.hpp" // for simd_type
 
 namespace va {
     template<typename FX>
@@ -15,41 +33,577 @@ namespace va {
         }
     };
 
-    template<typename OutputType, typename Result>
-    void assign_to_target(VArrayTarget target, Result&& result) {
+    // Returns the range of bytes spanned by the elements of the compute case, as [begin, end).
+    template<typename C>
+    std::pair<const char*, const char*> memory_range(const C& carray) {
+        const auto data = reinterpret_cast<const char*>(carray.data());
+        if (carray.size() == 0) {
+            return { data, data };
+        }
+
+        constexpr auto element_size = static_cast<std::ptrdiff_t>(sizeof(typename C::value_type));
+        std::ptrdiff_t begin = 0;
+        std::ptrdiff_t end = 1;
+        for (std::size_t i = 0; i < carray.dimension(); ++i) {
+            const auto extent = static_cast<std::ptrdiff_t>(carray.shape()[i] - 1) * carray.strides()[i];
+            if (extent < 0) {
+                begin += extent;
+            } else {
+                end += extent;
+            }
+        }
+
+        return { data + begin * element_size, data + end * element_size };
+    }
+
+    // Returns true if writing the target while reading from the argument could read already written elements.
+    template<typename Target, typename Arg>
+    bool may_alias(const Target& target, const Arg& arg) {
+        if constexpr (std::is_arithmetic_v<Arg>) {
+            // Scalars are passed by value.
+            return false;
+        } else {
+            // Each element is read before it is written, so an argument viewing exactly the target is safe.
+            if (static_cast<const void*>(target.data()) == static_cast<const void*>(arg.data())
+                && target.shape() == arg.shape()
+                && target.strides() == arg.strides()) {
+                return false;
+            }
+
+            const auto [target_begin, target_end] = memory_range(target);
+            const auto [arg_begin, arg_end] = memory_range(arg);
+            return target_begin < arg_end && arg_begin < target_end;
+        }
+    }
+
+    template<typename Target>
+    bool may_alias(const Target& target, const ComputeVariant& arg) {
+        return std::visit([&target](const auto& carray) { return may_alias(target, carray); }, arg);
+    }
+
+    template<typename Target>
+    bool may_alias(const Target&, const VConstant&) {
+        return false;
+    }
+
+    // Value strides for broadcasting a value of the given shape and strides to the target shape.
+    inline strides_type broadcast_strides(const shape_type& target_shape, const shape_type& shape, const strides_type& strides) {
+        if (shape.size() > target_shape.size()) {
+            throw std::runtime_error("Cannot broadcast the value to the target shape.");
+        }
+
+        strides_type result(target_shape.size(), 0);
+        const std::size_t dimension_offset = target_shape.size() - shape.size();
+        for (std::size_t i = 0; i < shape.size(); ++i) {
+            if (shape[i] == target_shape[dimension_offset + i]) {
+                result[dimension_offset + i] = shape[i] == 1 ? 0 : strides[i];
+            } else if (shape[i] != 1) {
+                throw std::runtime_error("Cannot broadcast the value to the target shape.");
+            }
+        }
+        return result;
+    }
+
+    // Copies the value to the target element by element, in row major order.
+    // The innermost dimension is a flat loop; contiguous rows of the same type are copied as a whole.
+    template <typename T, typename V>
+    void strided_copy(T* target, const strides_type& target_strides, const V* value, const strides_type& value_strides, const shape_type& shape) {
+        const std::size_t dimension = shape.size();
+        if (dimension == 0) {
+            *target = static_cast<T>(*value);
+            return;
+        }
+        if (std::find(shape.begin(), shape.end(), 0) != shape.end()) {
+            return;
+        }
+
+        const std::size_t inner = dimension - 1;
+        const std::size_t inner_size = shape[inner];
+        // Size 1 dimensions may have any stride.
+        const std::ptrdiff_t target_step = inner_size == 1 ? 1 : target_strides[inner];
+        const std::ptrdiff_t value_step = inner_size == 1 ? 0 : value_strides[inner];
+
+        shape_type index(inner, 0);
+        std::ptrdiff_t target_offset = 0;
+        std::ptrdiff_t value_offset = 0;
+
+        while (true) {
+            T* target_row = target + target_offset;
+            const V* value_row = value + value_offset;
+
+            if constexpr (std::is_same_v<T, V>) {
+                if (target_step == 1 && value_step == 1) {
+                    std::copy(value_row, value_row + inner_size, target_row);
+                } else if (value_step == 0) {
+                    for (std::size_t i = 0; i < inner_size; ++i) {
+                        target_row[static_cast<std::ptrdiff_t>(i) * target_step] = *value_row;
+                    }
+                } else {
+                    for (std::size_t i = 0; i < inner_size; ++i) {
+                        target_row[static_cast<std::ptrdiff_t>(i) * target_step] = value_row[static_cast<std::ptrdiff_t>(i) * value_step];
+                    }
+                }
+            } else {
+                for (std::size_t i = 0; i < inner_size; ++i) {
+                    target_row[static_cast<std::ptrdiff_t>(i) * target_step] = static_cast<T>(value_row[static_cast<std::ptrdiff_t>(i) * value_step]);
+                }
+            }
+
+            // Advance the outer dimensions like an odometer.
+            std::size_t d = inner;
+            while (true) {
+                if (d == 0) {
+                    return;
+                }
+                --d;
+
+                if (++index[d] < shape[d]) {
+                    target_offset += target_strides[d];
+                    value_offset += value_strides[d];
+                    break;
+                }
+
+                target_offset -= target_strides[d] * static_cast<std::ptrdiff_t>(shape[d] - 1);
+                value_offset -= value_strides[d] * static_cast<std::ptrdiff_t>(shape[d] - 1);
+                index[d] = 0;
+            }
+        }
+    }
+
+    // Evaluates the result into a row major buffer of the same shape.
+    // This is the only evaluation of the result we instantiate for compute targets, regardless of where it writes to.
+    template<typename R, typename Result>
+    void evaluate_to_buffer(R* data, const std::size_t size, const shape_type& shape, const Result& result) {
+        auto buffer = xt::adapt(data, size, xt::no_ownership(), shape);
+        xt::noalias(buffer) = result;
+    }
+
+    template<typename OutputType, typename Result, typename... Args>
+    void assign_to_target(VArrayTarget target, Result&& result, const Args&... args) {
         using R = typename std::decay_t<decltype(result)>::value_type;
 
-        std::visit([&result](auto&& target) {
+        std::visit([&result, &args...](auto&& target) {
             using PtrType = std::decay_t<decltype(target)>;
 
             if constexpr (std::is_same_v<PtrType, ComputeVariant *>) {
                 // Assign to compute case, broadcasting and casting if necessary.
-                std::visit([&result](auto &&ctarget) {
+                std::visit([&result, &args...](auto &&ctarget) {
                     using T = typename std::decay_t<decltype(ctarget)>::value_type;
-#ifdef NUMDOT_ASSIGN_INPLACE_DIRECTLY_INSTEAD_OF_COPYING_FIRST
 
-                    // About 30% of binary size is the first case, because assignment to a compute case can be difficult.
-                    // Another 20% is the two cases combined, which are inlined because they both assign directly to a new xarray.
                     if constexpr (std::is_same_v<T, R>) {
-                        // TODO Could use assign_xexpression if there is no aliasing, aka overlap of target and inputs.
-                        ctarget.computed_assign(result);
-                    } else
-#endif
-                    {
-                        // Make a copy, similar as in promote_compute_case_if_needed.
-                        // After copying we can be sure no aliasing is taking place, so we can assign with assign_xexpression.
-                        ctarget.assign_xexpression(xt::xarray<R>(result));
+                        const auto& result_shape = result.shape();
+
+                        if (
+                            std::equal(result_shape.begin(), result_shape.end(), ctarget.shape().begin(), ctarget.shape().end())
+                            && is_contiguous_in_order(ctarget.shape(), ctarget.strides(), xt::layout_type::row_major)
+                            && !(may_alias(ctarget, args) || ...)
+                        ) {
+                            // No broadcast, cast or overlap: write the result straight into the target.
+                            evaluate_to_buffer(ctarget.data(), ctarget.size(), ctarget.shape(), result);
+                            return;
+                        }
                     }
+
+                    // Evaluate to a temporary first, similar as in promote_compute_case_if_needed.
+                    // After copying we can be sure no aliasing is taking place, so we can copy it over element by element.
+                    // Assigning a casted or broadcast result directly would need far more instantiations.
+                    // Only the target's elements are written: its shape and strides are never changed, because the
+                    //  target may be the cached adaptor of an array (see VArray::compute_variant_for_write).
+                    auto temp = array_case<R>::from_shape(result.shape());
+                    evaluate_to_buffer(temp.data(), temp.size(), temp.shape(), result);
+                    const strides_type temp_strides = broadcast_strides(ctarget.shape(), temp.shape(), temp.strides());
+                    strided_copy(ctarget.data(), ctarget.strides(), temp.data(), temp_strides, ctarget.shape());
                 }, *target);
             } else {
                 // Create new array, assign to our target pointer.
                 // OutputType may be different from R, if we want different behavior than xtensor for computation.
-                *target = from_store(std::make_shared<xt::xarray<OutputType>>(result));
+                *target = from_store(make_store<OutputType>(result));
             }
         }, target);
     }
 
-    template<typename PromotionRule, typename Visitor>
+    // Views size elements at data as a 1-d compute case.
+    template<typename T>
+    compute_case<T> adapt_flat(T* data, const std::size_t size) {
+        // xtensor expects the stride of a dimension of size 1 to be 0.
+        const std::ptrdiff_t stride = size == 1 ? 0 : 1;
+
+        return xt::adapt(data, size, xt::no_ownership(), shape_type { size }, strides_type { stride });
+    }
+
+    // Views elements [begin, end) of a row major contiguous compute case as a 1-d compute case.
+    // Because the type stays the same, functions on the chunks re-use the instantiations for whole arrays.
+    template<typename T>
+    compute_case<T> flat_chunk(const compute_case<T>& carray, const std::size_t begin, const std::size_t end) {
+        return adapt_flat(const_cast<T*>(carray.data()) + begin, end - begin);
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    T flat_chunk(const T& scalar, std::size_t, std::size_t) {
+        return scalar;
+    }
+
+    // Like flat_chunk, but converts the chunk to NeededType, in the given scratch buffer if needed.
+    // The chunk must not be larger than pool::scratch_block_size.
+    template<typename NeededType, typename T>
+    compute_case<NeededType> flat_chunk_as(const compute_case<T>& carray, const std::size_t begin, const std::size_t end, const std::size_t scratch_index) {
+        if constexpr (std::is_same_v<T, NeededType>) {
+            return flat_chunk(carray, begin, end);
+        } else {
+            static_assert(sizeof(NeededType) <= sizeof(std::uint64_t), "Scratch buffers only fit dtypes up to 8 bytes.");
+
+            const auto buffer = static_cast<NeededType*>(pool::scratch_buffer(scratch_index));
+            std::transform(carray.data() + begin, carray.data() + end, buffer, [](const T value) {
+                return static_cast<NeededType>(value);
+            });
+            return adapt_flat(buffer, end - begin);
+        }
+    }
+
+    template<typename NeededType, typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    T flat_chunk_as(const T& scalar, std::size_t, std::size_t, std::size_t) {
+        return scalar;
+    }
+
+    template<typename NeededType>
+    compute_case<NeededType> flat_chunk_as(const ComputeVariant& carray, const std::size_t begin, const std::size_t end, const std::size_t scratch_index) {
+        return std::visit([begin, end, scratch_index](const auto& carray) {
+            return flat_chunk_as<NeededType>(carray, begin, end, scratch_index);
+        }, carray);
+    }
+
+    template<typename NeededType>
+    NeededType flat_chunk_as(const VConstant& constant, std::size_t, std::size_t, std::size_t) {
+        return std::visit([](const auto value) { return static_cast<NeededType>(value); }, constant);
+    }
+
+    template<typename Visitor>
+    struct xfunction_functor {
+        using type = void;
+    };
+
+    template<typename FX>
+    struct xfunction_functor<XFunction<FX>> {
+        using type = FX;
+    };
+
+    // The element-wise functor of an XFunction visitor, or void for other visitors.
+    template<typename Visitor>
+    using xfunction_functor_t = typename xfunction_functor<Visitor>::type;
+
+    template<typename FX, typename Void, typename... Batches>
+    struct has_simd_apply_impl : std::false_type {};
+
+    template<typename FX, typename... Batches>
+    struct has_simd_apply_impl<FX, std::void_t<decltype(std::declval<const FX&>().simd_apply(std::declval<const Batches&>()...))>, Batches...> : std::true_type {};
+
+    template<typename FX, typename... Batches>
+    constexpr bool has_simd_apply_v = has_simd_apply_impl<FX, void, Batches...>::value;
+
+    // Flat kernel operands are pointers to contiguous elements, or scalars.
+    template<typename T>
+    const T* flat_operand(const compute_case<T>& carray) {
+        return carray.data();
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    T flat_operand(const T& scalar) {
+        return scalar;
+    }
+
+    template<typename Operand>
+    auto flat_element(const Operand& operand, const std::size_t i) {
+        if constexpr (std::is_pointer_v<Operand>) {
+            return operand[i];
+        } else {
+            return operand;
+        }
+    }
+
+#ifdef NUMDOT_ISA_DISPATCH
+#if defined(__clang__)
+#define NUMDOT_TARGET(isa) __attribute__((target(isa)))
+#else
+// GCC only vectorizes loops at -O3 by default.
+#define NUMDOT_TARGET(isa) __attribute__((target(isa), optimize("tree-vectorize")))
+#endif
+
+    // The scalar loop of apply_flat, compiled for newer instruction sets. The compiler vectorizes it by itself.
+    template<typename FX, typename R, typename... Operands>
+    NUMDOT_TARGET("avx2,fma") void apply_flat_avx2(R* output, const std::size_t size, const Operands... operands) {
+        const FX fx {};
+        for (std::size_t i = 0; i < size; ++i) {
+            output[i] = static_cast<R>(fx(flat_element(operands, i)...));
+        }
+    }
+
+    template<typename FX, typename R, typename... Operands>
+    NUMDOT_TARGET("avx512f,avx512bw,avx512dq,avx512vl") void apply_flat_avx512(R* output, const std::size_t size, const Operands... operands) {
+        const FX fx {};
+        for (std::size_t i = 0; i < size; ++i) {
+            output[i] = static_cast<R>(fx(flat_element(operands, i)...));
+        }
+    }
+
+#undef NUMDOT_TARGET
+
+    // Functors that compile to a few instructions, so the loops above vectorize them for the newer instruction sets.
+    // Other functors call into libm, and would only be compiled again for nothing.
+    // These are inline baseline code, which GCC and Clang inline into the loops, because the loops' instruction sets
+    //  include the baseline.
+    template<typename FX>
+    constexpr bool is_inline_arithmetic_v =
+        std::is_same_v<FX, xt::detail::plus>
+        || std::is_same_v<FX, xt::detail::minus>
+        || std::is_same_v<FX, xt::detail::multiplies>
+        || std::is_same_v<FX, xt::detail::divides>
+        || std::is_same_v<FX, xt::detail::equal_to>
+        || std::is_same_v<FX, xt::detail::not_equal_to>
+        || std::is_same_v<FX, xt::detail::less>
+        || std::is_same_v<FX, xt::detail::less_equal>
+        || std::is_same_v<FX, xt::detail::greater>
+        || std::is_same_v<FX, xt::detail::greater_equal>
+        || std::is_same_v<FX, xt::detail::logical_and>
+        || std::is_same_v<FX, xt::detail::logical_or>;
+
+#ifdef XTENSOR_USE_XSIMD
+    // Whether to use the loops above instead of xsimd batches, which are limited to the baseline instruction set.
+    // Arithmetic operators vectorize well in any case. Other functors only if xsimd can't do them at all.
+    template<typename FX, typename T, typename R>
+    constexpr bool prefers_isa_dispatch_v = is_inline_arithmetic_v<FX> && (
+        std::is_same_v<FX, xt::detail::plus>
+        || std::is_same_v<FX, xt::detail::minus>
+        || std::is_same_v<FX, xt::detail::multiplies>
+        || std::is_same_v<FX, xt::detail::divides>
+        || !std::is_same_v<R, T>
+        || std::is_same_v<T, bool>
+        || std::is_same_v<xt_simd::simd_type<T>, T>
+    );
+#else
+    // Without xsimd, the loops above are the only vectorized ones.
+    template<typename FX, typename T, typename R>
+    constexpr bool prefers_isa_dispatch_v = is_inline_arithmetic_v<FX>;
+#endif
+#endif
+
+    // Computes output[i] = FX(operands[i]...) for i in [0, size), where operands are all of type T.
+    // This is what xtensor's assignment boils down to for contiguous arguments, but without stepping through
+    //  dynamic shapes and strides. If the functor supports it, most elements are computed in xsimd batches.
+    // With NUMDOT_ISA_DISPATCH, some functors use a loop compiled for the best instruction set of the running CPU.
+    template<typename FX, typename T, typename R, typename... Operands>
+    void apply_flat(R* output, const std::size_t size, const Operands... operands) {
+#ifdef NUMDOT_ISA_DISPATCH
+        if constexpr (prefers_isa_dispatch_v<FX, T, R>) {
+            switch (cpu::best_isa()) {
+                case cpu::Isa::AVX512:
+                    return apply_flat_avx512<FX>(output, size, operands...);
+                case cpu::Isa::AVX2:
+                    return apply_flat_avx2<FX>(output, size, operands...);
+                default:
+                    break;
+            }
+        }
+#endif
+
+        const FX fx {};
+        std::size_t i = 0;
+
+#ifdef XTENSOR_USE_XSIMD
+        using B = xt_simd::simd_type<T>;
+
+        if constexpr (
+            std::is_same_v<R, T>
+            && !std::is_same_v<T, bool>
+            && !std::is_same_v<B, T>
+            && has_simd_apply_v<FX, std::conditional_t<true, B, Operands>...>
+        ) {
+            static_assert(alignof(B) <= pool::alignment);
+            // Pool buffers are aligned for any batch, and so are views into them at offset 0 and block boundaries.
+            // If all arrays are aligned, aligned loads and stores are used.
+            const auto is_aligned = [](const auto& operand) {
+                if constexpr (std::is_pointer_v<std::decay_t<decltype(operand)>>) {
+                    return reinterpret_cast<std::uintptr_t>(operand) % alignof(B) == 0;
+                } else {
+                    return true;
+                }
+            };
+            const auto apply_batches = [&](auto aligned) {
+                constexpr bool is_aligned_v = decltype(aligned)::value;
+
+                const auto load = [](const auto& operand, const std::size_t index) {
+                    if constexpr (!std::is_pointer_v<std::decay_t<decltype(operand)>>) {
+                        return B(operand);
+                    } else if constexpr (is_aligned_v) {
+                        return B::load_aligned(operand + index);
+                    } else {
+                        return B::load_unaligned(operand + index);
+                    }
+                };
+
+                for (; i + B::size <= size; i += B::size) {
+                    const B result = fx.simd_apply(load(operands, i)...);
+                    if constexpr (is_aligned_v) {
+                        result.store_aligned(output + i);
+                    } else {
+                        result.store_unaligned(output + i);
+                    }
+                }
+            };
+
+            if (is_aligned(output) && (is_aligned(operands) && ...)) {
+                apply_batches(std::true_type {});
+            } else {
+                apply_batches(std::false_type {});
+            }
+        }
+#endif
+
+        for (; i < size; ++i) {
+            output[i] = static_cast<R>(fx(flat_element(operands, i)...));
+        }
+    }
+
+    // Scalar arguments are passed by value, and converted up front.
+    template<typename Arg>
+    constexpr bool is_scalar_argument_v = std::is_arithmetic_v<Arg> || std::is_same_v<Arg, VConstant>;
+
+    // Calls fn with the compute case of the argument, visiting it first if it is a ComputeVariant.
+    template<typename Fn, typename Arg>
+    decltype(auto) with_compute_case(Fn&& fn, const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, ComputeVariant>) {
+            return std::visit(std::forward<Fn>(fn), arg);
+        } else {
+            return std::forward<Fn>(fn)(arg);
+        }
+    }
+
+    // Returns true if the argument is an array that has to be converted to NeededType.
+    template<typename NeededType, typename Arg>
+    bool argument_needs_conversion(const Arg& arg) {
+        if constexpr (is_scalar_argument_v<Arg>) {
+            return false;
+        } else if constexpr (std::is_same_v<Arg, ComputeVariant>) {
+            return arg.index() != promote::dtype_of<NeededType>();
+        } else {
+            return !std::is_same_v<promote::value_type_of_t<Arg>, NeededType>;
+        }
+    }
+
+    // Evaluates an element-wise function in contiguous chunks, if all arguments are row major contiguous and of the same shape (or scalars).
+    // XFunction visitors are then computed with flat loops (see apply_flat), other visitors through xtensor per chunk.
+    // Arguments that need to be converted to InputType are converted block by block into scratch buffers,
+    //  instead of copying whole arrays. Large computations are spread over all threads.
+    // The result has to be written directly to the target.
+    // Arguments may be compute cases and scalars, or ComputeVariant and VConstant of any dtype.
+    // Returns false if the function should be evaluated normally instead.
+    template<typename InputType, typename OutputType, typename Visitor, typename... Args>
+    bool evaluate_elementwise_in_chunks(const Visitor& visitor, VArrayTarget target, const Args&... args) {
+        static_assert(sizeof...(Args) <= pool::max_scratch_buffers, "Each argument may need its own scratch buffer.");
+        const bool needs_conversion = (argument_needs_conversion<InputType>(args) || ...);
+        using FX = xfunction_functor_t<Visitor>;
+        constexpr bool has_flat_kernel = !std::is_void_v<FX>;
+
+        const shape_type* shape = nullptr;
+        bool is_flat = true;
+
+        ([&shape, &is_flat](const auto& arg) {
+            if constexpr (!is_scalar_argument_v<std::decay_t<decltype(arg)>>) {
+                with_compute_case([&shape, &is_flat](const auto& carray) {
+                    if (shape == nullptr) {
+                        shape = &carray.shape();
+                    } else if (carray.shape() != *shape) {
+                        is_flat = false;
+                    }
+                    is_flat = is_flat && is_contiguous_in_order(carray.shape(), carray.strides(), xt::layout_type::row_major);
+                }, arg);
+            }
+        }(args), ...);
+
+        if (shape == nullptr || !is_flat) {
+            return false;
+        }
+
+        const std::size_t size = std::accumulate(shape->begin(), shape->end(), static_cast<std::size_t>(1), std::multiplies());
+        const bool is_parallel = size >= parallel::get_threshold() && parallel::get_num_threads() > 1;
+        if (!has_flat_kernel && !needs_conversion && !is_parallel) {
+            return false;
+        }
+
+        using R = typename decltype(visitor(promote::promote_compute_case_if_needed<InputType>(flat_chunk_as<InputType>(args, 0, 0, 0))...))::value_type;
+
+        R* output = nullptr;
+        store_case<R> store;
+
+        std::visit([&](auto target) {
+            using PtrType = decltype(target);
+
+            if constexpr (std::is_same_v<PtrType, ComputeVariant*>) {
+                std::visit([&](auto& ctarget) {
+                    using T = typename std::decay_t<decltype(ctarget)>::value_type;
+
+                    if constexpr (std::is_same_v<T, R>) {
+                        if (
+                            ctarget.shape() == *shape
+                            && is_contiguous_in_order(ctarget.shape(), ctarget.strides(), xt::layout_type::row_major)
+                            && !(may_alias(ctarget, args) || ...)
+                        ) {
+                            output = ctarget.data();
+                        }
+                    }
+                }, *target);
+            } else if constexpr (std::is_same_v<R, OutputType>) {
+                store = make_store<R>(*shape);
+                output = store->data();
+            }
+        }, target);
+
+        if (output == nullptr) {
+            return false;
+        }
+
+        const auto evaluate_range = [&](const std::size_t begin, const std::size_t end) {
+            // Converted arguments are limited by the scratch buffers; otherwise, the whole range is one block.
+            const std::size_t block_size = needs_conversion ? pool::scratch_block_size : end - begin;
+
+            for (std::size_t block_begin = begin; block_begin < end; block_begin += block_size) {
+                const std::size_t block_end = std::min(block_begin + block_size, end);
+
+                // The chunks need to outlive the result, which may reference them.
+                std::size_t scratch_index = 0;
+                const std::tuple chunks { flat_chunk_as<InputType>(args, block_begin, block_end, scratch_index++)... };
+
+                std::apply([&](const auto&... chunks) {
+                    if constexpr (has_flat_kernel) {
+                        apply_flat<FX, InputType>(output + block_begin, block_end - block_begin, flat_operand(promote::promote_compute_case_if_needed<InputType>(chunks))...);
+                    } else {
+                        const auto result = visitor(promote::promote_compute_case_if_needed<InputType>(chunks)...);
+                        evaluate_to_buffer(output + block_begin, block_end - block_begin, shape_type { block_end - block_begin }, result);
+                    }
+                }, chunks);
+            }
+        };
+
+        if (is_parallel) {
+            // A few chunks per thread, so threads that finish early can steal work from the others.
+            // Chunks are split at multiples of pool::alignment elements, so they stay aligned for SIMD if the arrays are.
+            constexpr std::size_t unit = pool::alignment;
+            const std::size_t num_units = (size + unit - 1) / unit;
+            const std::size_t grain_size = std::max(num_units / (parallel::get_num_threads() * 4), 4096 / unit);
+            parallel::parallel_for(0, num_units, grain_size, [&](const std::size_t begin, const std::size_t end) {
+                evaluate_range(begin * unit, std::min(end * unit, size));
+            });
+        } else {
+            evaluate_range(0, size);
+        }
+
+        if (store) {
+            *std::get<std::optional<VArray>*>(target) = from_store(store);
+        }
+
+        return true;
+    }
+
+    template<typename PromotionRule, typename Visitor, bool IsElementwise = false>
     struct VArrayFunctionInplace {
         const Visitor visitor;
         const VArrayTarget target;
@@ -59,23 +613,148 @@ namespace va {
         }
 
         template<typename... Args>
-        void operator()(const compute_case<Args>&... args) const {
-            using InputType = typename PromotionRule::template input_type<Args...>;
+        void operator()(const Args&... args) const {
+            using InputType = typename PromotionRule::template input_type<promote::value_type_of_t<Args>...>;
             using OutputType = typename PromotionRule::template output_type<InputType>;
 
+            if constexpr (IsElementwise) {
+                if (evaluate_elementwise_in_chunks<InputType, OutputType>(visitor, target, args...)) {
+                    return;
+                }
+            }
+
             // Result of visitor invocation
             const auto result = visitor(promote::promote_compute_case_if_needed<InputType>(args)...);
 
-            assign_to_target<OutputType>(target, result);
+            // Arguments are passed along to detect overlap with the target.
+            assign_to_target<OutputType>(target, result, args...);
         }
     };
 
+    // Converts the argument to NeededType, so functions on it only need to be instantiated for NeededType.
+    // Arrays of another dtype are copied into storage, which needs to outlive the result.
+    template<typename NeededType>
+    compute_case<NeededType> promote_argument(const ComputeVariant& arg, std::optional<array_case<NeededType>>& storage) {
+        return std::visit([&storage](const auto& carray) -> compute_case<NeededType> {
+            using T = typename std::decay_t<decltype(carray)>::value_type;
+
+            if constexpr (std::is_same_v<T, NeededType>) {
+                return carray;
+            } else {
+                storage.emplace(carray);
+                return xt::adapt(storage->data(), storage->size(), xt::no_ownership(), storage->shape(), storage->strides());
+            }
+        }, arg);
+    }
+
+    template<typename NeededType>
+    NeededType promote_argument(const VConstant& arg, std::optional<array_case<NeededType>>&) {
+        return std::visit([](const auto value) { return static_cast<NeededType>(value); }, arg);
+    }
+
+    // Computes an element-wise function with all arguments converted to InputType.
+    template<typename PromotionRule, typename InputType, typename Visitor, typename... Args>
+    void apply_elementwise_as(const Visitor& visitor, VArrayTarget target, const Args&... args) {
+        using OutputType = typename PromotionRule::template output_type<InputType>;
+
+        if (evaluate_elementwise_in_chunks<InputType, OutputType>(visitor, target, args...)) {
+            return;
+        }
+
+        std::array<std::optional<array_case<InputType>>, sizeof...(Args)> storage;
+        std::size_t storage_index = 0;
+        const std::tuple promoted_args { promote_argument<InputType>(args, storage[storage_index++])... };
+
+        std::apply([&visitor, target](const auto&... promoted_args) {
+            const auto result = visitor(promoted_args...);
+
+            // Arguments are passed along to detect overlap with the target.
+            assign_to_target<OutputType>(target, result, promoted_args...);
+        }, promoted_args);
+    }
+
+    // Arguments are ComputeVariant or VConstant.
     template<typename PromotionRule, typename FX, typename... Args>
     static inline void xoperation_inplace(FX &&fx, VArrayTarget target, const Args&... args) {
+#ifdef NUMDOT_CAST_INSTEAD_OF_COPY_FOR_ARGUMENTS
+        // Casting needs a kernel for every combination of argument dtypes.
         std::visit(
-            VArrayFunctionInplace<PromotionRule, FX>{std::forward<FX>(fx), target },
+            VArrayFunctionInplace<PromotionRule, FX, true>{std::forward<FX>(fx), target },
             args...
         );
+#else
+        // Look up the input dtype first, and convert all arguments to it.
+        // This way, we need one kernel per input dtype instead of one per combination of argument dtypes,
+        //  e.g. 11^3 for clip. This is both smaller and faster to dispatch.
+        std::visit([&fx, target, &args...](const auto input_type) {
+            using InputType = decltype(input_type);
+
+            if constexpr (promote::is_input_type<PromotionRule, sizeof...(Args), InputType>()) {
+                apply_elementwise_as<PromotionRule, InputType>(fx, target, args...);
+            } else {
+                throw std::runtime_error("Internal error: unexpected input dtype.");
+            }
+        }, dtype_to_variant(promote::promoted_dtype<PromotionRule>(args...)));
+#endif
+    }
+
+    inline const ComputeVariant& to_compute_data(const std::reference_wrapper<const VArray>& array) {
+        return array.get().to_compute_variant();
+    }
+
+    inline const VConstant& to_compute_data(const VConstant& constant) {
+        return constant;
+    }
+
+    // Views the value as a 0-d compute case, without allocating a store for it.
+    template<typename T>
+    compute_case<T> adapt_scalar(T& value) {
+        return xt::adapt(&value, 1, xt::no_ownership(), shape_type {}, strides_type {});
+    }
+
+    // Computes the function of two scalars, and assigns the 0-d result to the target.
+    template<typename PromotionRule, typename FX>
+    void xoperation_on_constants(FX &&fx, VArrayTarget target, const VConstant& a, const VConstant& b) {
+        using F = xfunction_functor_t<std::decay_t<FX>>;
+
+        if constexpr (!std::is_void_v<F>) {
+            std::visit([target, &a, &b](const auto input_type) {
+                using InputType = decltype(input_type);
+
+                if constexpr (promote::is_input_type<PromotionRule, 2, InputType>()) {
+                    using OutputType = typename PromotionRule::template output_type<InputType>;
+
+                    const auto cast = [](const auto value) { return static_cast<InputType>(value); };
+                    auto value = F {}(std::visit(cast, a), std::visit(cast, b));
+                    assign_to_target<OutputType>(target, adapt_scalar(value));
+                } else {
+                    throw std::runtime_error("Internal error: unexpected input dtype.");
+                }
+            }, dtype_to_variant(promote::promoted_dtype<PromotionRule>(a, b)));
+        } else {
+            // xtensor needs at least one expression to evaluate, so we view a as a 0-d array.
+            // Doing it this way, we can re-use the array-scalar kernel.
+            std::visit([&fx, target, &b](auto a) {
+                const ComputeVariant a_array = adapt_scalar(a);
+                xoperation_inplace<PromotionRule>(std::forward<FX>(fx), target, a_array, b);
+            }, a);
+        }
+    }
+
+    template<typename PromotionRule, typename FX>
+    static inline void xoperation_inplace(FX &&fx, VArrayTarget target, const VDataRef& a, const VDataRef& b) {
+        std::visit([&fx, target](const auto& a, const auto& b) {
+            using A = std::decay_t<decltype(a)>;
+            using B = std::decay_t<decltype(b)>;
+
+            if constexpr (std::is_same_v<A, VConstant> && std::is_same_v<B, VConstant>) {
+                xoperation_on_constants<PromotionRule>(std::forward<FX>(fx), target, a, b);
+            }
+            else {
+                // Scalars are passed to the kernel directly, arrays as compute cases.
+                xoperation_inplace<PromotionRule>(std::forward<FX>(fx), target, to_compute_data(a), to_compute_data(b));
+            }
+        }, a, b);
     }
 
     template<typename PromotionRule, typename FX>
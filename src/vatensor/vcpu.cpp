@@ -0,0 +1,31 @@
+#include "vcpu.h"
+
+using namespace va;
+
+#ifdef NUMDOT_ISA_DISPATCH
+static cpu::Isa detect_isa() {
+    __builtin_cpu_init();
+
+    if (
+        __builtin_cpu_supports("avx512f")
+        && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512dq")
+        && __builtin_cpu_supports("avx512vl")
+    ) {
+        return cpu::Isa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return cpu::Isa::AVX2;
+    }
+    return cpu::Isa::Baseline;
+}
+#endif
+
+cpu::Isa cpu::best_isa() {
+#ifdef NUMDOT_ISA_DISPATCH
+    static const Isa isa = detect_isa();
+    return isa;
+#else
+    return Isa::Baseline;
+#endif
+}
@@ -0,0 +1,23 @@
+#ifndef VCPU_H
+#define VCPU_H
+
+// On x86_64 with GCC or Clang, some kernels are additionally compiled for newer instruction sets,
+//  and the best supported variant is chosen at runtime. Other platforms use their baseline (e.g. NEON on arm64).
+#if !defined(NUMDOT_DISABLE_ISA_DISPATCH) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NUMDOT_ISA_DISPATCH
+#endif
+
+namespace va {
+    namespace cpu {
+        enum class Isa {
+            Baseline,
+            AVX2,    // With FMA.
+            AVX512,  // F, BW, DQ and VL.
+        };
+
+        // The newest instruction set supported by both the running CPU and the build. Detected once.
+        Isa best_isa();
+    }
+}
+
+#endif //VCPU_H
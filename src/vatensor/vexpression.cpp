@@ -0,0 +1,224 @@
+#include "vexpression.h"
+
+#include <algorithm>     // for min, max
+#include <cstddef>       // for size_t
+#include <optional>      // for optional
+#include <stdexcept>     // for runtime_error
+#include <type_traits>   // for decay_t, is_same_v
+#include <utility>       // for move
+#include <vector>        // for vector
+#include "allocate.h"    // for empty, copy_as_dtype
+#include "vcompute.h"    // for flat_chunk, may_alias
+#include "vparallel.h"   // for parallel_for, get_threshold
+
+using namespace va;
+
+VExpressionPtr va::make_leaf(VData data) {
+    if (const auto array = std::get_if<VArray>(&data); array != nullptr && array->dimension() == 0) {
+        // Scalars are passed to the functions directly, and don't take part in the shape checks.
+        data = array->to_single_value();
+    }
+
+    return std::make_shared<const VExpression>(VExpression { std::move(data) });
+}
+
+VExpressionPtr va::make_unary(const UnaryFunction function, VExpressionPtr a) {
+    return std::make_shared<const VExpression>(VExpression { VExpression::Unary { function, std::move(a) } });
+}
+
+VExpressionPtr va::make_binary(const BinaryFunction function, VExpressionPtr a, VExpressionPtr b) {
+    return std::make_shared<const VExpression>(VExpression { VExpression::Binary { function, std::move(a), std::move(b) } });
+}
+
+static VArray data_as_array(const VData& data) {
+    return std::visit([](const auto& data) -> VArray {
+        if constexpr (std::is_same_v<std::decay_t<decltype(data)>, VArray>) {
+            return data;
+        } else {
+            return std::visit([](const auto value) {
+                return from_store(make_store<decltype(value)>(value));
+            }, data);
+        }
+    }, data);
+}
+
+// Calls the node's function, evaluating its children with evaluate_child.
+template <typename Node, typename EvaluateChild>
+static void apply_node(const Node& node, const VArrayTarget target, const EvaluateChild& evaluate_child) {
+    if constexpr (std::is_same_v<Node, VExpression::Unary>) {
+        node.function(target, data_as_array(evaluate_child(*node.a)));
+    } else {
+        const VData a = evaluate_child(*node.a);
+        const VData b = evaluate_child(*node.b);
+        node.function(target, to_data_ref(a), to_data_ref(b));
+    }
+}
+
+static VData evaluate_eager(const VExpression& expression) {
+    return std::visit([](const auto& node) -> VData {
+        using Node = std::decay_t<decltype(node)>;
+
+        if constexpr (std::is_same_v<Node, VData>) {
+            return node;
+        } else {
+            std::optional<VArray> result;
+            apply_node(node, &result, evaluate_eager);
+            return std::move(*result);
+        }
+    }, expression.node);
+}
+
+// Views elements [begin, end) of a row major contiguous array as a 1-d array.
+static VArray flat_block(const VArray& array, const std::size_t begin, const std::size_t end) {
+    const std::size_t size = end - begin;
+
+    return {
+        array.store,
+        shape_type { size },
+        strides_type { size == 1 ? 0 : 1 },
+        array.offset + begin,
+        xt::layout_type::dynamic
+    };
+}
+
+static VData evaluate_block(const VExpression& expression, const std::size_t begin, const std::size_t end) {
+    return std::visit([begin, end](const auto& node) -> VData {
+        using Node = std::decay_t<decltype(node)>;
+
+        if constexpr (std::is_same_v<Node, VData>) {
+            if (const auto array = std::get_if<VArray>(&node)) {
+                return flat_block(*array, begin, end);
+            }
+            return node;
+        } else {
+            std::optional<VArray> result;
+            apply_node(node, &result, [begin, end](const VExpression& child) {
+                return evaluate_block(child, begin, end);
+            });
+            return std::move(*result);
+        }
+    }, expression.node);
+}
+
+// Collects all array leaves. Returns false if they can't be evaluated in blocks.
+static bool collect_flat_leaves(const VExpression& expression, std::vector<const VArray*>& leaves) {
+    return std::visit([&leaves](const auto& node) -> bool {
+        using Node = std::decay_t<decltype(node)>;
+
+        if constexpr (std::is_same_v<Node, VData>) {
+            if (const auto array = std::get_if<VArray>(&node)) {
+                if (
+                    array->contiguity() != xt::layout_type::row_major
+                    || (!leaves.empty() && array->shape != leaves.front()->shape)
+                ) {
+                    return false;
+                }
+                leaves.push_back(array);
+            }
+            return true;
+        } else if constexpr (std::is_same_v<Node, VExpression::Unary>) {
+            return collect_flat_leaves(*node.a, leaves);
+        } else {
+            return collect_flat_leaves(*node.a, leaves) && collect_flat_leaves(*node.b, leaves);
+        }
+    }, expression.node);
+}
+
+// Evaluates the node in blocks, writing each block directly to the target.
+// Returns false if the target doesn't allow this, e.g. because it overlaps an argument.
+template <typename Node>
+static bool evaluate_blocked(const Node& node, const VArrayTarget target, const std::vector<const VArray*>& leaves) {
+    const shape_type& shape = leaves.front()->shape;
+    const std::size_t size = leaves.front()->size();
+
+    std::optional<VArray> output;
+    const ComputeVariant* compute_target = nullptr;
+
+    if (std::holds_alternative<std::optional<VArray>*>(target)) {
+        // The first element tells us the result's dtype.
+        std::optional<VArray> first;
+        apply_node(node, &first, [](const VExpression& child) { return evaluate_block(child, 0, 1); });
+        output = empty(first->dtype(), shape);
+    } else {
+        compute_target = std::get<ComputeVariant*>(target);
+
+        const bool is_writable_in_blocks = std::visit([&shape, &leaves](const auto& ctarget) {
+            if (
+                !std::equal(ctarget.shape().begin(), ctarget.shape().end(), shape.begin(), shape.end())
+                || !is_contiguous_in_order(ctarget.shape(), ctarget.strides(), xt::layout_type::row_major)
+            ) {
+                return false;
+            }
+
+            // Blocks are written after they are read, so only partial overlap is a problem.
+            for (const VArray* leaf : leaves) {
+                if (std::visit([&ctarget](const auto& carray) { return may_alias(ctarget, carray); }, leaf->to_compute_variant())) {
+                    return false;
+                }
+            }
+            return true;
+        }, *compute_target);
+
+        if (!is_writable_in_blocks) {
+            return false;
+        }
+    }
+
+    const auto evaluate_blocks = [&node, &output, compute_target](const std::size_t begin, const std::size_t end) {
+        for (std::size_t block_begin = begin; block_begin < end; block_begin += expression_block_size) {
+            const std::size_t block_end = std::min(block_begin + expression_block_size, end);
+
+            ComputeVariant block_target = output.has_value()
+                ? flat_block(*output, block_begin, block_end).to_compute_variant()
+                : std::visit([block_begin, block_end](const auto& ctarget) -> ComputeVariant {
+                    return flat_chunk(ctarget, block_begin, block_end);
+                }, *compute_target);
+
+            apply_node(node, &block_target, [block_begin, block_end](const VExpression& child) {
+                return evaluate_block(child, block_begin, block_end);
+            });
+        }
+    };
+
+    if (size < parallel::get_threshold()) {
+        evaluate_blocks(0, size);
+    } else {
+        const std::size_t grain_size = std::max(size / (parallel::get_num_threads() * 4), expression_block_size);
+        parallel::parallel_for(0, size, grain_size, evaluate_blocks);
+    }
+
+    if (output.has_value()) {
+        *std::get<std::optional<VArray>*>(target) = std::move(output);
+    }
+
+    return true;
+}
+
+void va::evaluate(const VArrayTarget target, const VExpression& expression) {
+    std::visit([target, &expression](const auto& node) {
+        using Node = std::decay_t<decltype(node)>;
+
+        if constexpr (std::is_same_v<Node, VData>) {
+            const auto new_target = std::get_if<std::optional<VArray>*>(&target);
+            if (new_target == nullptr) {
+                throw std::runtime_error("Cannot assign an expression without functions.");
+            }
+
+            // Don't return a view of the leaf; the result should be independent of it.
+            const VArray array = data_as_array(node);
+            **new_target = copy_as_dtype(array, array.dtype());
+        } else {
+            std::vector<const VArray*> leaves;
+            if (
+                collect_flat_leaves(expression, leaves)
+                && !leaves.empty()
+                && leaves.front()->size() > 0
+                && evaluate_blocked(node, target, leaves)
+            ) {
+                return;
+            }
+
+            apply_node(node, target, evaluate_eager);
+        }
+    }, expression.node);
+}
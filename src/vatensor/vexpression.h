@@ -0,0 +1,47 @@
+#ifndef VEXPRESSION_H
+#define VEXPRESSION_H
+
+#include "auto_defines.h"
+#include <cstddef>   // for size_t
+#include <memory>    // for shared_ptr
+#include <variant>   // for variant
+#include "varray.h"  // for VArray, VData, VArrayTarget
+
+namespace va {
+    // Any of the element-wise functions, e.g. va::sin or va::add.
+    using UnaryFunction = void (*)(VArrayTarget target, const VArray& a);
+    using BinaryFunction = void (*)(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+
+    // Number of elements evaluated at once by evaluate. Intermediate results of this size stay in cache.
+    constexpr std::size_t expression_block_size = 4096;
+
+    // A tree of element-wise functions that is only evaluated when needed.
+    // Nodes are immutable, so they can be shared between expressions.
+    struct VExpression {
+        struct Unary {
+            UnaryFunction function;
+            std::shared_ptr<const VExpression> a;
+        };
+
+        struct Binary {
+            BinaryFunction function;
+            std::shared_ptr<const VExpression> a;
+            std::shared_ptr<const VExpression> b;
+        };
+
+        std::variant<VData, Unary, Binary> node;
+    };
+
+    using VExpressionPtr = std::shared_ptr<const VExpression>;
+
+    VExpressionPtr make_leaf(VData data);
+    VExpressionPtr make_unary(UnaryFunction function, VExpressionPtr a);
+    VExpressionPtr make_binary(BinaryFunction function, VExpressionPtr a, VExpressionPtr b);
+
+    // Evaluates the whole tree in one pass over the arrays.
+    // If all arrays have the same shape and are contiguous, this is done in blocks of expression_block_size elements,
+    //  so intermediate results never need full size arrays. Otherwise, functions are evaluated one after another.
+    void evaluate(VArrayTarget target, const VExpression& expression);
+}
+
+#endif //VEXPRESSION_H
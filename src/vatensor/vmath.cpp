@@ -11,106 +11,106 @@
 
 using namespace va;
 
-void va::add(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::add(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::detail::plus>>(
         XFunction<xt::detail::plus> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::subtract(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::subtract(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::detail::minus>>(
         XFunction<xt::detail::minus> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::multiply(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::multiply(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::detail::multiplies>>(
         XFunction<xt::detail::multiplies> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::divide(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::divide(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::detail::divides>>(
         XFunction<xt::detail::divides> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::remainder(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::remainder(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::math::remainder_fun>>(
         XFunction<xt::math::remainder_fun> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::pow(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::pow(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::num_function_result<xt::math::pow_fun>>(
         XFunction<xt::math::pow_fun> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::minimum(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::minimum(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_in_common_out>(
         XFunction<xt::math::minimum<void>> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
 
-void va::maximum(VArrayTarget target, const VArray& a, const VArray& b) {
+void va::maximum(VArrayTarget target, const VDataRef& a, const VDataRef& b) {
 #ifdef NUMDOT_DISABLE_MATH_FUNCTIONS
     throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_MATH_FUNCTIONS to enable it.");
 #else
     va::xoperation_inplace<promote::common_in_common_out>(
         XFunction<xt::math::maximum<void>> {},
         target,
-        a.to_compute_variant(),
-        b.to_compute_variant()
+        a,
+        b
     );
 #endif
 }
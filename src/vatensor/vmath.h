@@ -5,15 +5,15 @@
 #include "varray.h"
 
 namespace va {
-    void add(VArrayTarget target, const VArray& a, const VArray& b);
-    void subtract(VArrayTarget target, const VArray& a, const VArray& b);
-    void multiply(VArrayTarget target, const VArray& a, const VArray& b);
-    void divide(VArrayTarget target, const VArray& a, const VArray& b);
-    void remainder(VArrayTarget target, const VArray& a, const VArray& b);
-    void pow(VArrayTarget target, const VArray& a, const VArray& b);
+    void add(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void subtract(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void multiply(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void divide(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void remainder(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void pow(VArrayTarget target, const VDataRef& a, const VDataRef& b);
 
-    void minimum(VArrayTarget target, const VArray& a, const VArray& b);
-    void maximum(VArrayTarget target, const VArray& a, const VArray& b);
+    void minimum(VArrayTarget target, const VDataRef& a, const VDataRef& b);
+    void maximum(VArrayTarget target, const VDataRef& a, const VDataRef& b);
     void clip(VArrayTarget target, const VArray& a, const VArray& lo, const VArray& hi);
 
     void sign(VArrayTarget target, const VArray& array);
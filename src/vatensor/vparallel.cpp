@@ -0,0 +1,373 @@
+#include "vparallel.h"
+
+#include <algorithm>           // for max
+#include <atomic>              // for atomic
+#include <cstddef>             // for size_t
+
+#ifdef NUMDOT_USE_THREADS
+#include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
+#include <exception>           // for exception_ptr, current_exception, rethrow_exception
+#include <memory>              // for unique_ptr, make_unique
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional, nullopt
+#include <stdexcept>           // for runtime_error
+#include <thread>              // for thread, hardware_concurrency, yield
+#include <vector>              // for vector
+#endif
+
+#ifndef NUMDOT_PARALLEL_THRESHOLD
+// Below this, a single thread finishes most element-wise functions faster than other threads wake up.
+#define NUMDOT_PARALLEL_THRESHOLD (1 << 16)
+#endif
+
+using namespace va;
+
+static std::atomic<std::size_t> threshold { NUMDOT_PARALLEL_THRESHOLD };
+
+void parallel::set_threshold(const std::size_t num_elements) {
+    threshold.store(num_elements, std::memory_order_relaxed);
+}
+
+std::size_t parallel::get_threshold() {
+    return threshold.load(std::memory_order_relaxed);
+}
+
+#ifndef NUMDOT_USE_THREADS
+
+void parallel::set_num_threads(std::size_t num_threads) {}
+
+std::size_t parallel::get_num_threads() {
+    return 1;
+}
+
+void parallel::parallel_for(const std::size_t begin, const std::size_t end, std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& fn) {
+    if (begin < end) {
+        fn(begin, end);
+    }
+}
+
+void parallel::stop_threads() {}
+
+#else
+
+static std::size_t hardware_threads() {
+    return std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), static_cast<std::size_t>(1));
+}
+
+namespace {
+    // One call to parallel_for. It lives on the calling thread's stack until all its elements are done.
+    struct Job {
+        const std::function<void(std::size_t, std::size_t)>& fn;
+        const std::size_t grain_size;
+        std::atomic<std::size_t> remaining;
+
+        std::atomic<bool> failed { false };
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        Job* job;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // The owner pushes and pops at the back, thieves take from the front, where the largest ranges are.
+    struct TaskDeque {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+}
+
+// Each worker owns a deque; threads outside the pool share deque 0.
+// Workers are started on the first parallel job, so loading the library doesn't spawn threads.
+// When there is nothing to steal, workers park on a condition variable until new tasks are pushed.
+class Scheduler {
+public:
+    ~Scheduler() {
+        join_workers();
+    }
+
+    void set_num_threads(const std::size_t num_threads) {
+        const PauseRuns pause(*this);
+        std::lock_guard lock(workers_mutex);
+        join_workers();
+        this->num_threads.store(num_threads == 0 ? hardware_threads() : num_threads, std::memory_order_relaxed);
+    }
+
+    std::size_t get_num_threads() const {
+        return num_threads.load(std::memory_order_relaxed);
+    }
+
+    void stop() {
+        const PauseRuns pause(*this);
+        std::lock_guard lock(workers_mutex);
+        join_workers();
+    }
+
+    void run(const std::size_t begin, const std::size_t end, const std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& fn) {
+        const ActiveRun active_run(*this);
+        ensure_started();
+
+        Job job { fn, std::max(grain_size, static_cast<std::size_t>(1)), end - begin };
+        push(Task { &job, begin, end });
+
+        // Help with whatever work is pending (possibly of other jobs) until our own job is done.
+        // This is also what makes nested calls safe: a waiting worker never blocks.
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            if (const auto task = take()) {
+                execute(*task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+private:
+    // Outermost run() calls from outside the pool are counted, so the workers and deques aren't replaced while in use.
+    // Nested calls are covered by their outermost call, and must not wait, because that one can't finish without them.
+    class ActiveRun {
+    public:
+        explicit ActiveRun(Scheduler& scheduler) : scheduler(scheduler), is_outermost(!is_worker && run_depth == 0) {
+            ++run_depth;
+            if (!is_outermost) {
+                return;
+            }
+
+            std::unique_lock lock(scheduler.runs_mutex);
+            scheduler.runs_changed.wait(lock, [&scheduler] { return !scheduler.is_paused; });
+            ++scheduler.active_runs;
+        }
+
+        ~ActiveRun() {
+            --run_depth;
+            if (!is_outermost) {
+                return;
+            }
+
+            {
+                std::lock_guard lock(scheduler.runs_mutex);
+                --scheduler.active_runs;
+            }
+            scheduler.runs_changed.notify_all();
+        }
+
+    private:
+        Scheduler& scheduler;
+        const bool is_outermost;
+    };
+
+    // Waits until no run() is active, and keeps new ones from starting until destroyed.
+    class PauseRuns {
+    public:
+        explicit PauseRuns(Scheduler& scheduler) : scheduler(scheduler) {
+            if (is_worker || run_depth > 0) {
+                throw std::runtime_error("The number of threads can't be changed from within a parallel computation.");
+            }
+
+            std::unique_lock lock(scheduler.runs_mutex);
+            scheduler.runs_changed.wait(lock, [&scheduler] { return !scheduler.is_paused; });
+            scheduler.is_paused = true;
+            scheduler.runs_changed.wait(lock, [&scheduler] { return scheduler.active_runs == 0; });
+        }
+
+        ~PauseRuns() {
+            {
+                std::lock_guard lock(scheduler.runs_mutex);
+                scheduler.is_paused = false;
+            }
+            scheduler.runs_changed.notify_all();
+        }
+
+    private:
+        Scheduler& scheduler;
+    };
+
+    void ensure_started() {
+        if (started.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::lock_guard lock(workers_mutex);
+        if (started.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const std::size_t num_threads = get_num_threads();
+        deques.clear();
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            deques.push_back(std::make_unique<TaskDeque>());
+        }
+        for (std::size_t i = 1; i < num_threads; ++i) {
+            workers.emplace_back([this, i] { work(i); });
+        }
+
+        started.store(true, std::memory_order_release);
+    }
+
+    void join_workers() {
+        {
+            std::lock_guard lock(park_mutex);
+            stopping = true;
+        }
+        wake_up.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        {
+            std::lock_guard lock(park_mutex);
+            stopping = false;
+        }
+        started.store(false, std::memory_order_release);
+    }
+
+    void push(const Task& task) {
+        auto& deque = *deques[deque_index];
+        {
+            std::lock_guard lock(deque.mutex);
+            deque.tasks.push_back(task);
+        }
+        queued_tasks.fetch_add(1);
+
+        // Sequentially consistent with the check in work(), so a parking worker can't miss the new task.
+        if (num_parked.load() > 0) {
+            std::lock_guard lock(park_mutex);
+            wake_up.notify_one();
+        }
+    }
+
+    std::optional<Task> take() {
+        const std::size_t num_deques = deques.size();
+
+        // Own deque first (most recently split, so likely still in cache), then steal from the others in turn.
+        for (std::size_t i = 0; i < num_deques; ++i) {
+            const bool is_own = i == 0;
+            auto& deque = *deques[(deque_index + i) % num_deques];
+
+            std::lock_guard lock(deque.mutex);
+            if (deque.tasks.empty()) {
+                continue;
+            }
+
+            const Task task = is_own ? deque.tasks.back() : deque.tasks.front();
+            if (is_own) {
+                deque.tasks.pop_back();
+            } else {
+                deque.tasks.pop_front();
+            }
+            queued_tasks.fetch_sub(1);
+            return task;
+        }
+
+        return std::nullopt;
+    }
+
+    void execute(Task task) {
+        Job& job = *task.job;
+
+        // Keep the first half, and leave the second half to thieves (or ourselves later).
+        while (task.end - task.begin > job.grain_size) {
+            const std::size_t middle = task.begin + (task.end - task.begin) / 2;
+            push(Task { &job, middle, task.end });
+            task.end = middle;
+        }
+
+        if (!job.failed.load(std::memory_order_relaxed)) {
+            try {
+                job.fn(task.begin, task.end);
+            }
+            catch (...) {
+                std::lock_guard lock(job.error_mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+                job.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        // This must be the last access to the job: once it reaches 0, the owner may return.
+        job.remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+    }
+
+    void work(const std::size_t index) {
+        deque_index = index;
+        is_worker = true;
+
+        while (true) {
+            if (const auto task = take()) {
+                execute(*task);
+                continue;
+            }
+
+            std::unique_lock lock(park_mutex);
+            num_parked.fetch_add(1);
+            wake_up.wait(lock, [this] { return stopping || queued_tasks.load() > 0; });
+            num_parked.fetch_sub(1);
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    std::mutex workers_mutex;
+    std::atomic<std::size_t> num_threads { hardware_threads() };
+    std::atomic<bool> started { false };
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<TaskDeque>> deques;
+
+    std::atomic<std::size_t> queued_tasks { 0 };
+    std::atomic<std::size_t> num_parked { 0 };
+    std::mutex park_mutex;
+    std::condition_variable wake_up;
+    bool stopping = false;
+
+    std::mutex runs_mutex;
+    std::condition_variable runs_changed;
+    std::size_t active_runs = 0;
+    bool is_paused = false;
+
+    static thread_local std::size_t deque_index;
+    static thread_local bool is_worker;
+    static thread_local std::size_t run_depth;
+};
+
+thread_local std::size_t Scheduler::deque_index = 0;
+thread_local bool Scheduler::is_worker = false;
+thread_local std::size_t Scheduler::run_depth = 0;
+
+static Scheduler scheduler;
+
+void parallel::set_num_threads(const std::size_t num_threads) {
+    scheduler.set_num_threads(num_threads);
+}
+
+std::size_t parallel::get_num_threads() {
+    return scheduler.get_num_threads();
+}
+
+void parallel::parallel_for(const std::size_t begin, const std::size_t end, const std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+    if (end - begin <= grain_size || scheduler.get_num_threads() <= 1) {
+        fn(begin, end);
+        return;
+    }
+
+    scheduler.run(begin, end, grain_size, fn);
+}
+
+void parallel::stop_threads() {
+    scheduler.stop();
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef VPARALLEL_H
+#define VPARALLEL_H
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+
+namespace va {
+    namespace parallel {
+        // The number of threads used for large computations, including the calling thread.
+        // 0 resets to the number of hardware threads. Without NUMDOT_USE_THREADS, this is always 1.
+        // Waits for running computations to finish first, and throws if called from within parallel_for.
+        void set_num_threads(std::size_t num_threads);
+        std::size_t get_num_threads();
+
+        // Computations on fewer elements than this run on the calling thread only,
+        //  because waking up other threads costs more than it saves.
+        void set_threshold(std::size_t num_elements);
+        std::size_t get_threshold();
+
+        // Calls fn(chunk_begin, chunk_end) for disjoint chunks covering [begin, end), spread over all threads.
+        // Ranges are split in halves until they are no larger than grain_size, so chunks are at least half that size.
+        // Idle threads steal the largest pending chunks from busy ones, so uneven chunks even out.
+        // fn may itself call parallel_for; the waiting thread helps with any pending work until its range is done.
+        // Returns once all chunks are done. If any chunk throws, the first exception is rethrown here.
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size, const std::function<void(std::size_t chunk_begin, std::size_t chunk_end)>& fn);
+
+        // Joins all worker threads. They are started again when needed.
+        void stop_threads();
+    }
+}
+
+#endif //VPARALLEL_H
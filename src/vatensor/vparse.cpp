@@ -0,0 +1,430 @@
+#include "vparse.h"
+
+#include <cctype>         // for isalpha, isalnum, isdigit, isspace
+#include <cstdint>        // for int64_t
+#include <locale>         // for locale
+#include <mutex>          // for mutex, lock_guard
+#include <sstream>        // for istringstream
+#include <stdexcept>      // for runtime_error
+#include <string_view>    // for string_view
+#include <type_traits>    // for decay_t, is_floating_point_v, is_same_v
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include "comparison.h"   // for equal_to, greater, greater_equal, less, less_equal
+#include "logical.h"      // for logical_and, logical_not, logical_or, logical_xor
+#include "round.h"        // for ceil, floor, nearbyint, round, trunc
+#include "trigonometry.h" // for acos, acosh, asin, asinh, atan, atan2, atanh
+#include "vmath.h"        // for abs, add, deg2rad, divide, exp, log, maximum
+
+#ifndef NUMDOT_EXPRESSION_CACHE_SIZE
+// Compiled expressions are tiny, but scripts that build sources dynamically shouldn't grow the cache forever.
+#define NUMDOT_EXPRESSION_CACHE_SIZE 256
+#endif
+
+using namespace va;
+
+static const std::unordered_map<std::string_view, UnaryFunction>& unary_functions() {
+    static const std::unordered_map<std::string_view, UnaryFunction> functions {
+        { "sign", &va::sign },
+        { "abs", &va::abs },
+        { "square", &va::square },
+        { "sqrt", &va::sqrt },
+        { "exp", &va::exp },
+        { "log", &va::log },
+        { "rad2deg", &va::rad2deg },
+        { "deg2rad", &va::deg2rad },
+        { "sin", &va::sin },
+        { "cos", &va::cos },
+        { "tan", &va::tan },
+        { "asin", &va::asin },
+        { "acos", &va::acos },
+        { "atan", &va::atan },
+        { "sinh", &va::sinh },
+        { "cosh", &va::cosh },
+        { "tanh", &va::tanh },
+        { "asinh", &va::asinh },
+        { "acosh", &va::acosh },
+        { "atanh", &va::atanh },
+        { "floor", &va::floor },
+        { "ceil", &va::ceil },
+        { "round", &va::round },
+        { "trunc", &va::trunc },
+        { "rint", &va::nearbyint },
+        { "logical_not", &va::logical_not },
+    };
+    return functions;
+}
+
+static const std::unordered_map<std::string_view, BinaryFunction>& binary_functions() {
+    static const std::unordered_map<std::string_view, BinaryFunction> functions {
+        { "add", &va::add },
+        { "subtract", &va::subtract },
+        { "multiply", &va::multiply },
+        { "divide", &va::divide },
+        { "remainder", &va::remainder },
+        { "pow", &va::pow },
+        { "minimum", &va::minimum },
+        { "maximum", &va::maximum },
+        { "atan2", &va::atan2 },
+        { "equal", &va::equal_to },
+        { "not_equal", &va::not_equal_to },
+        { "greater", &va::greater },
+        { "greater_equal", &va::greater_equal },
+        { "less", &va::less },
+        { "less_equal", &va::less_equal },
+        { "logical_and", &va::logical_and },
+        { "logical_or", &va::logical_or },
+        { "logical_xor", &va::logical_xor },
+    };
+    return functions;
+}
+
+namespace {
+    // Recursive descent parser, from the lowest to the highest precedence:
+    // |, ^, &, ~, comparisons, + -, * / %, unary -, **, then numbers, names, calls and parentheses.
+    class Parser {
+    public:
+        explicit Parser(const std::string& source) : source(source) {}
+
+        VCompiledExpression parse() {
+            parse_or();
+
+            skip_whitespace();
+            if (position < source.size()) {
+                throw_unexpected();
+            }
+
+            return std::move(result);
+        }
+
+    private:
+        using Node = decltype(VCompiledExpression::nodes)::value_type;
+
+        std::size_t add_node(Node node) {
+            result.nodes.push_back(std::move(node));
+            return result.nodes.size() - 1;
+        }
+
+        std::size_t add_binary(const BinaryFunction function, const std::size_t a, const std::size_t b) {
+            return add_node(VCompiledExpression::Binary { function, a, b });
+        }
+
+        void skip_whitespace() {
+            while (position < source.size() && std::isspace(static_cast<unsigned char>(source[position]))) {
+                ++position;
+            }
+        }
+
+        // Consumes the token if it's next, unless it's only the start of a longer operator (e.g. * in **).
+        bool consume(const std::string_view token, const char unless_followed_by = '\0') {
+            skip_whitespace();
+            if (source.compare(position, token.size(), token) != 0) {
+                return false;
+            }
+            const std::size_t end = position + token.size();
+            if (unless_followed_by != '\0' && end < source.size() && source[end] == unless_followed_by) {
+                return false;
+            }
+            position = end;
+            return true;
+        }
+
+        void expect(const std::string_view token) {
+            if (!consume(token)) {
+                throw_unexpected();
+            }
+        }
+
+        [[noreturn]] void throw_unexpected() const {
+            if (position >= source.size()) {
+                throw std::runtime_error("Unexpected end of expression.");
+            }
+            throw std::runtime_error("Unexpected '" + std::string(1, source[position]) + "' at position " + std::to_string(position) + ".");
+        }
+
+        std::size_t parse_or() {
+            std::size_t a = parse_xor();
+            while (consume("|")) {
+                a = add_binary(&va::logical_or, a, parse_xor());
+            }
+            return a;
+        }
+
+        std::size_t parse_xor() {
+            std::size_t a = parse_and();
+            while (consume("^")) {
+                a = add_binary(&va::logical_xor, a, parse_and());
+            }
+            return a;
+        }
+
+        std::size_t parse_and() {
+            std::size_t a = parse_not();
+            while (consume("&")) {
+                a = add_binary(&va::logical_and, a, parse_not());
+            }
+            return a;
+        }
+
+        std::size_t parse_not() {
+            if (consume("~")) {
+                const std::size_t a = parse_not();
+                return add_node(VCompiledExpression::Unary { &va::logical_not, a });
+            }
+            return parse_comparison();
+        }
+
+        std::size_t parse_comparison() {
+            const std::size_t a = parse_additive();
+
+            // Like in numexpr, comparisons don't chain.
+            if (consume("==")) return add_binary(&va::equal_to, a, parse_additive());
+            if (consume("!=")) return add_binary(&va::not_equal_to, a, parse_additive());
+            if (consume("<=")) return add_binary(&va::less_equal, a, parse_additive());
+            if (consume(">=")) return add_binary(&va::greater_equal, a, parse_additive());
+            if (consume("<")) return add_binary(&va::less, a, parse_additive());
+            if (consume(">")) return add_binary(&va::greater, a, parse_additive());
+            return a;
+        }
+
+        std::size_t parse_additive() {
+            std::size_t a = parse_term();
+            while (true) {
+                if (consume("+")) {
+                    a = add_binary(&va::add, a, parse_term());
+                }
+                else if (consume("-")) {
+                    a = add_binary(&va::subtract, a, parse_term());
+                }
+                else {
+                    return a;
+                }
+            }
+        }
+
+        std::size_t parse_term() {
+            std::size_t a = parse_unary();
+            while (true) {
+                if (consume("*", '*')) {
+                    a = add_binary(&va::multiply, a, parse_unary());
+                }
+                else if (consume("/")) {
+                    a = add_binary(&va::divide, a, parse_unary());
+                }
+                else if (consume("%")) {
+                    a = add_binary(&va::remainder, a, parse_unary());
+                }
+                else {
+                    return a;
+                }
+            }
+        }
+
+        std::size_t parse_unary() {
+            if (consume("-")) {
+                const std::size_t a = parse_unary();
+                // Fold negative literals, so they stay constants of the same type.
+                if (const auto constant = std::get_if<VConstant>(&result.nodes[a])) {
+                    *constant = std::visit([](const auto value) -> VConstant {
+                        if constexpr (std::is_floating_point_v<decltype(value)>) {
+                            return -value;
+                        } else {
+                            return -static_cast<int64_t>(value);
+                        }
+                    }, *constant);
+                    return a;
+                }
+                // Multiplying keeps the sign of zero, unlike subtracting from 0.
+                const std::size_t minus_one = add_node(VConstant { static_cast<int64_t>(-1) });
+                return add_binary(&va::multiply, minus_one, a);
+            }
+            if (consume("+")) {
+                return parse_unary();
+            }
+            return parse_power();
+        }
+
+        std::size_t parse_power() {
+            const std::size_t a = parse_primary();
+            if (consume("**")) {
+                // Right associative, and binds tighter than unary - on its left: -a**2 == -(a**2).
+                return add_binary(&va::pow, a, parse_unary());
+            }
+            return a;
+        }
+
+        std::size_t parse_primary() {
+            skip_whitespace();
+            if (position >= source.size()) {
+                throw_unexpected();
+            }
+
+            const char c = source[position];
+            if (consume("(")) {
+                const std::size_t a = parse_or();
+                expect(")");
+                return a;
+            }
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                return parse_number();
+            }
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                return parse_name();
+            }
+
+            throw_unexpected();
+        }
+
+        std::size_t parse_number() {
+            const std::size_t begin = position;
+            bool is_float = false;
+
+            while (position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))) ++position;
+            if (position < source.size() && source[position] == '.') {
+                is_float = true;
+                ++position;
+                while (position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))) ++position;
+            }
+            if (position < source.size() && (source[position] == 'e' || source[position] == 'E')) {
+                is_float = true;
+                ++position;
+                if (position < source.size() && (source[position] == '+' || source[position] == '-')) ++position;
+                while (position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))) ++position;
+            }
+
+            // The classic locale always uses '.' as the decimal point.
+            std::istringstream stream(source.substr(begin, position - begin));
+            stream.imbue(std::locale::classic());
+
+            VConstant value;
+            if (is_float) {
+                double_t number;
+                stream >> number;
+                value = number;
+            } else {
+                int64_t number;
+                stream >> number;
+                value = number;
+            }
+
+            if (stream.fail()) {
+                position = begin;
+                throw std::runtime_error("Invalid number at position " + std::to_string(begin) + ".");
+            }
+            return add_node(value);
+        }
+
+        std::size_t parse_name() {
+            const std::size_t begin = position;
+            while (position < source.size() && (std::isalnum(static_cast<unsigned char>(source[position])) || source[position] == '_')) {
+                ++position;
+            }
+            const std::string name = source.substr(begin, position - begin);
+
+            if (consume("(")) {
+                return parse_call(name);
+            }
+
+            if (name == "true" || name == "false") {
+                return add_node(VConstant { name == "true" });
+            }
+
+            auto& variables = result.variables;
+            std::size_t index = 0;
+            while (index < variables.size() && variables[index] != name) ++index;
+            if (index == variables.size()) {
+                variables.push_back(name);
+            }
+            return add_node(VCompiledExpression::Variable { index });
+        }
+
+        std::size_t parse_call(const std::string& name) {
+            std::vector<std::size_t> args;
+            if (!consume(")")) {
+                do {
+                    args.push_back(parse_or());
+                } while (consume(","));
+                expect(")");
+            }
+
+            if (const auto unary = unary_functions().find(name); unary != unary_functions().end()) {
+                if (args.size() != 1) {
+                    throw std::runtime_error("Function '" + name + "' takes 1 argument, but got " + std::to_string(args.size()) + ".");
+                }
+                return add_node(VCompiledExpression::Unary { unary->second, args[0] });
+            }
+            if (const auto binary = binary_functions().find(name); binary != binary_functions().end()) {
+                if (args.size() != 2) {
+                    throw std::runtime_error("Function '" + name + "' takes 2 arguments, but got " + std::to_string(args.size()) + ".");
+                }
+                return add_binary(binary->second, args[0], args[1]);
+            }
+
+            throw std::runtime_error("Unknown function '" + name + "'.");
+        }
+
+        const std::string& source;
+        std::size_t position = 0;
+        VCompiledExpression result;
+    };
+}
+
+VExpressionPtr VCompiledExpression::bind(const std::vector<VData>& values) const {
+    if (values.size() != variables.size()) {
+        throw std::runtime_error("Wrong number of values for the expression's variables.");
+    }
+
+    std::vector<VExpressionPtr> expressions;
+    expressions.reserve(nodes.size());
+
+    for (const auto& node : nodes) {
+        expressions.push_back(std::visit([&values, &expressions](const auto& node) -> VExpressionPtr {
+            using Node = std::decay_t<decltype(node)>;
+
+            if constexpr (std::is_same_v<Node, VConstant>) {
+                return make_leaf(node);
+            } else if constexpr (std::is_same_v<Node, Variable>) {
+                return make_leaf(values[node.index]);
+            } else if constexpr (std::is_same_v<Node, Unary>) {
+                return make_unary(node.function, expressions[node.a]);
+            } else {
+                return make_binary(node.function, expressions[node.a], expressions[node.b]);
+            }
+        }, node));
+    }
+
+    return expressions.back();
+}
+
+std::shared_ptr<const VCompiledExpression> va::compile_expression(const std::string& source) {
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const VCompiledExpression>> cache;
+
+    {
+        std::lock_guard lock(cache_mutex);
+        if (const auto cached = cache.find(source); cached != cache.end()) {
+            return cached->second;
+        }
+    }
+
+    // Parse outside the lock; if another thread compiles the same source meanwhile, either result is fine.
+    auto compiled = std::make_shared<const VCompiledExpression>(Parser(source).parse());
+
+    std::lock_guard lock(cache_mutex);
+    if (cache.size() >= NUMDOT_EXPRESSION_CACHE_SIZE) {
+        cache.clear();
+    }
+    cache.emplace(source, compiled);
+
+    return compiled;
+}
+
+UnaryFunction va::find_unary_function(const std::string_view name) {
+    const auto function = unary_functions().find(name);
+    return function == unary_functions().end() ? nullptr : function->second;
+}
+
+BinaryFunction va::find_binary_function(const std::string_view name) {
+    const auto function = binary_functions().find(name);
+    return function == binary_functions().end() ? nullptr : function->second;
+}
@@ -0,0 +1,52 @@
+#ifndef VPARSE_H
+#define VPARSE_H
+
+#include "auto_defines.h"
+#include <cstddef>        // for size_t
+#include <memory>         // for shared_ptr
+#include <string>         // for string
+#include <string_view>    // for string_view
+#include <variant>        // for variant
+#include <vector>         // for vector
+#include "varray.h"       // for VConstant, VData
+#include "vexpression.h"  // for UnaryFunction, BinaryFunction, VExpressionPtr
+
+namespace va {
+    // A parsed expression string, e.g. "a * b + sin(c) * 0.5", with placeholders for its variables.
+    struct VCompiledExpression {
+        struct Variable {
+            std::size_t index;
+        };
+
+        struct Unary {
+            UnaryFunction function;
+            std::size_t a;
+        };
+
+        struct Binary {
+            BinaryFunction function;
+            std::size_t a;
+            std::size_t b;
+        };
+
+        // Children come before their parents; the last node is the root.
+        std::vector<std::variant<VConstant, Variable, Unary, Binary>> nodes;
+        // Names of the variables, in order of first use.
+        std::vector<std::string> variables;
+
+        // Builds an expression tree, with values[i] in place of variables[i].
+        VExpressionPtr bind(const std::vector<VData>& values) const;
+    };
+
+    // Parses the source, or returns the cached result if the same source was compiled before.
+    // Supports numbers, true and false, variables, + - * / % **, comparisons, & | ^ ~ (logical),
+    //  and calls to element-wise functions like sin(a) or maximum(a, b).
+    // Throws std::runtime_error for invalid source.
+    std::shared_ptr<const VCompiledExpression> compile_expression(const std::string& source);
+
+    // The element-wise function called by the name in expressions, e.g. "sin" or "add", or nullptr if there is none.
+    UnaryFunction find_unary_function(std::string_view name);
+    BinaryFunction find_binary_function(std::string_view name);
+}
+
+#endif //VPARSE_H
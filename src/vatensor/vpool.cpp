@@ -0,0 +1,170 @@
+#include "vpool.h"
+
+#include <array>    // for array
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <new>      // for operator new, operator delete, align_val_t
+#include <vector>   // for vector
+
+#ifndef NUMDOT_POOL_MAX_RETAINED_BYTES
+// 64 MiB per thread, enough to recycle the temporaries of most per-frame workloads.
+#define NUMDOT_POOL_MAX_RETAINED_BYTES (64 * 1024 * 1024)
+#endif
+
+using namespace va;
+
+// Blocks are rounded up to a power of two, so each size class can serve any request that falls into it.
+// Tiny blocks are rounded up to the alignment, and huge blocks are not pooled at all.
+static constexpr std::size_t min_size_class_log2 = 6;  // 64 bytes
+static_assert(static_cast<std::size_t>(1) << min_size_class_log2 >= pool::alignment);
+static constexpr std::size_t max_size_class_log2 = 28;  // 256 MiB
+static constexpr std::size_t num_size_classes = max_size_class_log2 - min_size_class_log2 + 1;
+
+static std::atomic<std::size_t> max_retained_bytes { NUMDOT_POOL_MAX_RETAINED_BYTES };
+
+static constexpr std::size_t size_of_class(const std::size_t size_class) {
+    return static_cast<std::size_t>(1) << (size_class + min_size_class_log2);
+}
+
+// Returns num_size_classes for sizes that aren't pooled.
+static std::size_t size_class_of(const std::size_t size) {
+    // Checked first, so the shifts below stay in range even for sizes from an overflowed shape product.
+    if (size > size_of_class(num_size_classes - 1)) {
+        return num_size_classes;
+    }
+
+    std::size_t size_class = 0;
+    while (size_of_class(size_class) < size) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+static void* system_allocate(const std::size_t size) {
+    return ::operator new(size, std::align_val_t { pool::alignment });
+}
+
+static void system_deallocate(void* ptr) noexcept {
+    ::operator delete(ptr, std::align_val_t { pool::alignment });
+}
+
+struct FreeLists {
+    std::array<std::vector<void*>, num_size_classes> blocks;
+    std::size_t retained_bytes = 0;
+
+    void release() noexcept {
+        for (auto& size_class_blocks : blocks) {
+            for (void* ptr : size_class_blocks) {
+                system_deallocate(ptr);
+            }
+            size_class_blocks.clear();
+        }
+        retained_bytes = 0;
+    }
+
+    ~FreeLists();
+};
+
+static thread_local FreeLists free_lists;
+// Blocks may still be freed after the thread's free lists were destroyed, e.g. by other thread_local or static objects.
+// This flag is trivially destructible, so it stays valid for the thread's whole lifetime.
+static thread_local bool free_lists_destroyed = false;
+
+FreeLists::~FreeLists() {
+    release();
+    free_lists_destroyed = true;
+}
+
+void* pool::allocate(const std::size_t size) {
+    const std::size_t size_class = size_class_of(size);
+
+    if (size_class >= num_size_classes) {
+        return system_allocate(size);
+    }
+
+    if (!free_lists_destroyed) {
+        auto& size_class_blocks = free_lists.blocks[size_class];
+
+        if (!size_class_blocks.empty()) {
+            void* ptr = size_class_blocks.back();
+            size_class_blocks.pop_back();
+            free_lists.retained_bytes -= size_of_class(size_class);
+            return ptr;
+        }
+    }
+
+    return system_allocate(size_of_class(size_class));
+}
+
+void pool::deallocate(void* ptr, const std::size_t size) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    const std::size_t size_class = size_class_of(size);
+
+    if (size_class >= num_size_classes || free_lists_destroyed) {
+        system_deallocate(ptr);
+        return;
+    }
+
+    const std::size_t block_size = size_of_class(size_class);
+    if (free_lists.retained_bytes + block_size > max_retained_bytes.load(std::memory_order_relaxed)) {
+        system_deallocate(ptr);
+        return;
+    }
+
+    try {
+        free_lists.blocks[size_class].push_back(ptr);
+        free_lists.retained_bytes += block_size;
+    }
+    catch (...) {
+        // Couldn't grow the free list; just give the block back.
+        system_deallocate(ptr);
+    }
+}
+
+void pool::set_max_retained_bytes(const std::size_t size) {
+    max_retained_bytes.store(size, std::memory_order_relaxed);
+
+    // Other threads keep their blocks until they are reused, but won't retain more than the new limit.
+    if (!free_lists_destroyed && free_lists.retained_bytes > size) {
+        free_lists.release();
+    }
+}
+
+std::size_t pool::get_max_retained_bytes() {
+    return max_retained_bytes.load(std::memory_order_relaxed);
+}
+
+void pool::release_retained() {
+    if (!free_lists_destroyed) {
+        free_lists.release();
+    }
+}
+
+// Large enough for scratch_block_size elements of the widest dtype.
+static constexpr std::size_t scratch_buffer_bytes = pool::scratch_block_size * sizeof(std::uint64_t);
+
+struct ScratchBuffers {
+    std::array<void*, pool::max_scratch_buffers> buffers {};
+
+    ~ScratchBuffers() {
+        for (void* ptr : buffers) {
+            if (ptr != nullptr) {
+                system_deallocate(ptr);
+            }
+        }
+    }
+};
+
+static thread_local ScratchBuffers scratch_buffers;
+
+void* pool::scratch_buffer(const std::size_t index) {
+    void*& ptr = scratch_buffers.buffers[index];
+    if (ptr == nullptr) {
+        ptr = system_allocate(scratch_buffer_bytes);
+    }
+    return ptr;
+}
@@ -0,0 +1,63 @@
+#ifndef VPOOL_H
+#define VPOOL_H
+
+#include <cstddef>  // for size_t
+
+namespace va {
+    namespace pool {
+        // All blocks are aligned to this many bytes.
+        // This is a cache line on most machines, and enough for aligned SIMD loads and stores up to AVX-512.
+        constexpr std::size_t alignment = 64;
+
+        // Returns a block of at least size bytes, aligned to the above alignment.
+        // Blocks are recycled from the calling thread's free lists if possible, and requested from the system otherwise.
+        void* allocate(std::size_t size);
+
+        // Returns a block obtained through allocate (with the same size) to the calling thread's free lists.
+        // If the free lists are full, the block is returned to the system instead.
+        void deallocate(void* ptr, std::size_t size) noexcept;
+
+        // The maximum number of bytes each thread keeps in its free lists for later reuse.
+        // Setting this to 0 effectively disables the pool.
+        void set_max_retained_bytes(std::size_t size);
+        std::size_t get_max_retained_bytes();
+
+        // Returns all blocks retained by the calling thread to the system.
+        void release_retained();
+
+        // Per-thread buffers for converting arguments block by block, rather than copying whole arrays.
+        // Each holds scratch_block_size elements of any dtype. Indices below max_scratch_buffers are valid.
+        // The contents are only valid until the calling thread requests the same buffer again.
+        constexpr std::size_t scratch_block_size = 4096;
+        constexpr std::size_t max_scratch_buffers = 4;
+        void* scratch_buffer(std::size_t index);
+    }
+
+    // Allocator routing all allocations through the pool above.
+    // Used for store buffers (and their shared_ptr control blocks), which are allocated and freed for every operation.
+    template <typename T>
+    struct pool_allocator {
+        using value_type = T;
+
+        pool_allocator() noexcept = default;
+
+        template <typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(pool::allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept {
+            pool::deallocate(ptr, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const pool_allocator<U>&) const noexcept { return false; }
+    };
+}
+
+#endif //VPOOL_H
@@ -0,0 +1,87 @@
+#include "vprogram.h"
+
+#include <type_traits>  // for decay_t, is_same_v
+#include <variant>      // for visit, get_if
+#include <utility>      // for move
+#include "vcompute.h"   // for broadcast_strides
+
+using namespace va;
+
+// Throws if the array can't be written to the target, so this fails when recording rather than when running.
+// Element-wise results have the broadcast shape of the arguments, which broadcasts to the target if each argument does.
+static void check_broadcasts_to(const VArray& target, const VArray& array) {
+    broadcast_strides(target.shape, array.shape, array.strides);
+}
+
+static void check_broadcasts_to(const VArray& target, const VData& data) {
+    if (const auto array = std::get_if<VArray>(&data)) {
+        check_broadcasts_to(target, *array);
+    }
+}
+
+static void check_broadcasts_to(const VArray& target, const VExpression& expression) {
+    std::visit([&target](const auto& node) {
+        using Node = std::decay_t<decltype(node)>;
+
+        if constexpr (std::is_same_v<Node, VData>) {
+            check_broadcasts_to(target, node);
+        } else if constexpr (std::is_same_v<Node, VExpression::Unary>) {
+            check_broadcasts_to(target, *node.a);
+        } else {
+            check_broadcasts_to(target, *node.a);
+            check_broadcasts_to(target, *node.b);
+        }
+    }, expression.node);
+}
+
+void VProgram::assign(const VArray& target, VExpressionPtr expression) {
+    check_broadcasts_to(target, *expression);
+
+    if (const auto value = std::get_if<VData>(&expression->node)) {
+        // va::evaluate can only copy leaves into new arrays.
+        steps.push_back({ target, Assign { *value } });
+    } else {
+        steps.push_back({ target, Evaluate { std::move(expression) } });
+    }
+}
+
+void VProgram::reduce(const VArray& target, const ReductionFunction function, VArray array, Axes axes) {
+    steps.push_back({ target, Reduce { function, std::move(array), std::move(axes) } });
+}
+
+void VProgram::call(const VArray& target, const UnaryFunction function, VArray a) {
+    check_broadcasts_to(target, a);
+    steps.push_back({ target, CallUnary { function, std::move(a) } });
+}
+
+void VProgram::call(const VArray& target, const BinaryFunction function, VData a, VData b) {
+    check_broadcasts_to(target, a);
+    check_broadcasts_to(target, b);
+    steps.push_back({ target, CallBinary { function, std::move(a), std::move(b) } });
+}
+
+void VProgram::run() {
+    for (Step& step : steps) {
+        std::visit([&step](const auto& operation) {
+            using Operation = std::decay_t<decltype(operation)>;
+
+            if constexpr (std::is_same_v<Operation, Assign>) {
+                std::visit([&step](const auto& value) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(value)>, VArray>) {
+                        step.target_array.set_with_array(value);
+                    } else {
+                        step.target_array.fill(value);
+                    }
+                }, operation.value);
+            } else if constexpr (std::is_same_v<Operation, Evaluate>) {
+                evaluate(&step.target_array.compute_variant_for_write(), *operation.expression);
+            } else if constexpr (std::is_same_v<Operation, Reduce>) {
+                operation.function(&step.target_array.compute_variant_for_write(), operation.array, operation.axes);
+            } else if constexpr (std::is_same_v<Operation, CallUnary>) {
+                operation.function(&step.target_array.compute_variant_for_write(), operation.a);
+            } else {
+                operation.function(&step.target_array.compute_variant_for_write(), to_data_ref(operation.a), to_data_ref(operation.b));
+            }
+        }, step.operation);
+    }
+}
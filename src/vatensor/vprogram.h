@@ -0,0 +1,68 @@
+#ifndef VPROGRAM_H
+#define VPROGRAM_H
+
+#include "auto_defines.h"
+#include <cstddef>        // for size_t
+#include <variant>        // for variant
+#include <vector>         // for vector
+#include "varray.h"       // for VArray, VData, Axes
+#include "vexpression.h"  // for VExpressionPtr, UnaryFunction, BinaryFunction
+
+namespace va {
+    // Any of the reductions, e.g. va::sum or va::max.
+    using ReductionFunction = void (*)(VArrayTarget target, const VArray& array, const Axes& axes);
+
+    // A recorded sequence of functions, each writing to a fixed array.
+    // Arguments, functions and targets are resolved when recording, so running the program only calls the functions.
+    // Arrays are referenced, not copied: the program sees changes to them, including those made by earlier steps.
+    struct VProgram {
+        // Writes the value to the target, broadcasting and casting if needed.
+        struct Assign {
+            VData value;
+        };
+
+        struct Evaluate {
+            VExpressionPtr expression;
+        };
+
+        struct Reduce {
+            ReductionFunction function;
+            VArray array;
+            Axes axes;
+        };
+
+        // Calls an element-wise function directly, without building an expression.
+        struct CallUnary {
+            UnaryFunction function;
+            VArray a;
+        };
+
+        struct CallBinary {
+            BinaryFunction function;
+            VData a;
+            VData b;
+        };
+
+        struct Step {
+            // Keeps the target's buffer alive; results are written through its compute variant.
+            VArray target_array;
+            std::variant<Assign, Evaluate, Reduce, CallUnary, CallBinary> operation;
+        };
+
+        std::vector<Step> steps;
+
+        // These throw std::runtime_error if an array argument doesn't broadcast to the target, so this fails when
+        //  recording rather than when running.
+        void assign(const VArray& target, VExpressionPtr expression);
+        void call(const VArray& target, UnaryFunction function, VArray a);
+        void call(const VArray& target, BinaryFunction function, VData a, VData b);
+
+        void reduce(const VArray& target, ReductionFunction function, VArray array, Axes axes);
+
+        // Runs all steps in order.
+        // Throws std::runtime_error if a step fails; the steps before it have been run by then.
+        void run();
+    };
+}
+
+#endif //VPROGRAM_H
@@ -1,6 +1,11 @@
 #ifndef VPROMOTE_H
 #define VPROMOTE_H
 
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <utility>  // for index_sequence, make_index_sequence
+#include <variant>  // for variant_alternative_t, variant_size_v
+
 namespace va {
     namespace promote {
         template<typename NeededType, typename Type>
@@ -9,6 +14,8 @@ namespace va {
                 // Most common situation: the argument we need is the same as the argument that's given.
                 return arg;
             } else {
+                // Element-wise functions on contiguous arguments of the same shape don't get here; they convert
+                //  block by block instead (see evaluate_elementwise_in_chunks). This is for all other cases.
                 // Casting can considerably increase performance (from a small test, it was 25%).
                 // However, this is only relevant for operations that even need casting.
                 // The cost for casting instead of copying is a much larger binary size (100% increase).
@@ -16,11 +23,31 @@ namespace va {
 #ifdef NUMDOT_CAST_INSTEAD_OF_COPY_FOR_ARGUMENTS
                 return xt::cast<NeededType>(arg);
 #else
-                return xt::xarray<NeededType>(arg);
+                return array_case<NeededType>(arg);
 #endif
             }
         }
 
+        template<typename NeededType, typename Type, typename = std::enable_if_t<std::is_arithmetic_v<Type>>>
+        NeededType promote_compute_case_if_needed(const Type &arg) {
+            // Scalars are cheap to convert, and will be broadcast by xtensor.
+            return static_cast<NeededType>(arg);
+        }
+
+        // The value type of a kernel argument, which may be a compute case or a scalar.
+        template<typename Arg>
+        struct value_type_of {
+            using type = Arg;
+        };
+
+        template<typename T>
+        struct value_type_of<compute_case<T>> {
+            using type = T;
+        };
+
+        template<typename Arg>
+        using value_type_of_t = typename value_type_of<Arg>::type;
+
         template<typename Arg>
         using int64_if_bool_else_id = typename std::conditional<
             std::is_same_v<Arg, bool>,
@@ -117,6 +144,63 @@ namespace va {
             template<typename InputType>
             using output_type = bool;
         };
+
+        constexpr std::size_t num_dtypes = std::variant_size_v<VConstant>;
+
+        // The DType of a value type, which is its index in VConstant.
+        template<typename T, std::size_t I = 0>
+        constexpr DType dtype_of() {
+            static_assert(I < num_dtypes, "The type is not a supported dtype.");
+
+            if constexpr (std::is_same_v<T, std::variant_alternative_t<I, VConstant>>) {
+                return static_cast<DType>(I);
+            } else {
+                return dtype_of<T, I + 1>();
+            }
+        }
+
+        constexpr std::size_t pow_num_dtypes(const std::size_t exponent) {
+            return exponent == 0 ? 1 : num_dtypes * pow_num_dtypes(exponent - 1);
+        }
+
+        // The input dtype for the argument dtypes encoded in Index, with one base num_dtypes digit per argument.
+        template<typename PromotionRule, std::size_t Arity, std::size_t Index, std::size_t... Args>
+        constexpr DType promoted_dtype_at(std::index_sequence<Args...>) {
+            return dtype_of<typename PromotionRule::template input_type<
+                std::variant_alternative_t<Index / pow_num_dtypes(Arity - 1 - Args) % num_dtypes, VConstant>...
+            >>();
+        }
+
+        template<typename PromotionRule, std::size_t Arity, std::size_t... Indices>
+        constexpr std::array<DType, sizeof...(Indices)> make_promotion_table(std::index_sequence<Indices...>) {
+            return { promoted_dtype_at<PromotionRule, Arity, Indices>(std::make_index_sequence<Arity>{})... };
+        }
+
+        // The input dtype for every combination of argument dtypes, computed at compile time.
+        // This lets element-wise functions look up the input dtype first, and instantiate a kernel only per input dtype.
+        template<typename PromotionRule, std::size_t Arity>
+        constexpr std::array<DType, pow_num_dtypes(Arity)> promotion_table = make_promotion_table<PromotionRule, Arity>(
+            std::make_index_sequence<pow_num_dtypes(Arity)>{}
+        );
+
+        // Returns true if some combination of argument dtypes promotes to InputType.
+        template<typename PromotionRule, std::size_t Arity, typename InputType>
+        constexpr bool is_input_type() {
+            for (const DType dtype : promotion_table<PromotionRule, Arity>) {
+                if (dtype == dtype_of<InputType>()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Looks up the input dtype for the arguments, which are ComputeVariant or VConstant.
+        template<typename PromotionRule, typename... Args>
+        DType promoted_dtype(const Args&... args) {
+            std::size_t index = 0;
+            ((index = index * num_dtypes + args.index()), ...);
+            return promotion_table<PromotionRule, sizeof...(Args)>[index];
+        }
     }
 }
 
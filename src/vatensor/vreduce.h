@@ -0,0 +1,889 @@
+#ifndef VREDUCE_H
+#define VREDUCE_H
+
+#include <algorithm>    // for min, max, find, fill_n, nth_element, sort
+#include <atomic>       // for atomic
+#include <cmath>        // for sqrt, double_t
+#include <cstddef>      // for size_t, ptrdiff_t
+#include <cstdint>      // for int64_t, uint64_t
+#include <cstring>      // for memcpy
+#include <limits>       // for numeric_limits
+#include <memory>       // for unique_ptr
+#include <numeric>      // for iota
+#include <optional>     // for optional
+#include <stdexcept>    // for runtime_error
+#include <type_traits>  // for conditional_t, is_floating_point_v, is_signed_v, is_same_v, void_t
+#include <utility>      // for declval
+#include <variant>      // for visit, get_if
+#include <vector>       // for vector
+#include "varray.h"     // for VArray, Axes, compute_case, make_store, from_store
+#include "vcompute.h"   // for assign_to_target
+#include "vparallel.h"  // for parallel_for, get_threshold, get_num_threads
+#include "vpromote.h"   // for num_common_type, num_matching_float_or_default
+
+namespace va {
+    namespace reduce {
+        // Returns the reduced dimensions in ascending order, with negative axes counting from the end.
+        inline shape_type normalize_axes(const Axes& axes, const std::size_t dimension) {
+            shape_type result;
+
+            if (std::holds_alternative<std::nullptr_t>(axes)) {
+                for (std::size_t i = 0; i < dimension; ++i) {
+                    result.push_back(i);
+                }
+                return result;
+            }
+
+            for (const std::ptrdiff_t axis : std::get<GivenAxes>(axes)) {
+                const std::ptrdiff_t normalized = axis < 0 ? axis + static_cast<std::ptrdiff_t>(dimension) : axis;
+                if (normalized < 0 || normalized >= static_cast<std::ptrdiff_t>(dimension)) {
+                    throw std::runtime_error("Axis out of bounds.");
+                }
+                if (std::find(result.begin(), result.end(), static_cast<std::size_t>(normalized)) != result.end()) {
+                    throw std::runtime_error("Duplicate axis.");
+                }
+                result.push_back(static_cast<std::size_t>(normalized));
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        // Integers are summed in 64 bits, so intermediate results don't overflow; floats in their own type,
+        //  because pairwise summation keeps their error small.
+        template<typename T>
+        using sum_accumulator_t = std::conditional_t<
+            std::is_floating_point_v<T>,
+            T,
+            std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>
+        >;
+
+        // Combines size elements with op, in a tree of blocks like NumPy does for sums.
+        // The error grows with O(log n) rather than O(n), and the 8 independent lanes can be vectorized.
+        template<typename Acc, typename Op, typename T>
+        Acc pairwise(const T* data, const std::size_t size, const std::ptrdiff_t stride, const Acc identity, const Op& op) {
+            constexpr std::size_t lanes = 8;
+            constexpr std::size_t block_size = 128;
+
+            if (size < lanes) {
+                Acc result = identity;
+                for (std::size_t i = 0; i < size; ++i) {
+                    result = op(result, static_cast<Acc>(data[static_cast<std::ptrdiff_t>(i) * stride]));
+                }
+                return result;
+            }
+
+            if (size <= block_size) {
+                Acc lane[lanes];
+                for (std::size_t j = 0; j < lanes; ++j) {
+                    lane[j] = static_cast<Acc>(data[static_cast<std::ptrdiff_t>(j) * stride]);
+                }
+
+                std::size_t i = lanes;
+                if (stride == 1) {
+                    // Separate loop, so the compiler knows the lanes are adjacent.
+                    for (; i + lanes <= size; i += lanes) {
+                        for (std::size_t j = 0; j < lanes; ++j) {
+                            lane[j] = op(lane[j], static_cast<Acc>(data[i + j]));
+                        }
+                    }
+                } else {
+                    for (; i + lanes <= size; i += lanes) {
+                        for (std::size_t j = 0; j < lanes; ++j) {
+                            lane[j] = op(lane[j], static_cast<Acc>(data[static_cast<std::ptrdiff_t>(i + j) * stride]));
+                        }
+                    }
+                }
+
+                Acc result = op(op(op(lane[0], lane[1]), op(lane[2], lane[3])), op(op(lane[4], lane[5]), op(lane[6], lane[7])));
+                for (; i < size; ++i) {
+                    result = op(result, static_cast<Acc>(data[static_cast<std::ptrdiff_t>(i) * stride]));
+                }
+                return result;
+            }
+
+            // Split in two halves, keeping the first a multiple of the lanes.
+            std::size_t half = size / 2;
+            half -= half % lanes;
+            return op(
+                pairwise(data, half, stride, identity, op),
+                pairwise(data + static_cast<std::ptrdiff_t>(half) * stride, size - half, stride, identity, op)
+            );
+        }
+
+        // Whether the Reducer has is_decided(acc), which tells that more elements won't change the accumulator.
+        template<typename Reducer, typename Acc, typename = void>
+        struct can_short_circuit : std::false_type {};
+
+        template<typename Reducer, typename Acc>
+        struct can_short_circuit<Reducer, Acc, std::void_t<decltype(Reducer::is_decided(std::declval<const Acc&>()))>> : std::true_type {};
+
+        template<typename Reducer, typename Acc>
+        bool is_decided(const Acc& acc) {
+            if constexpr (can_short_circuit<Reducer, Acc>::value) {
+                return Reducer::is_decided(acc);
+            } else {
+                return false;
+            }
+        }
+
+        // Reduces the flat range [data, data + size) to one accumulator.
+        // Large ranges are split into a fixed number of chunks, which are spread over the threads and merged in order,
+        //  so the result doesn't depend on how the threads were scheduled.
+        // Once a chunk is decided (see is_decided), chunks that haven't started yet are skipped.
+        template<typename Reducer, typename InputType, typename T>
+        auto accumulate_flat(const T* data, const std::size_t size) {
+            using Acc = typename Reducer::template accumulator<InputType>;
+
+            const std::size_t num_threads = parallel::get_num_threads();
+            if (size < parallel::get_threshold() || num_threads <= 1) {
+                Acc acc = Reducer::template identity<InputType>();
+                Reducer::accumulate(acc, data, size, 1);
+                return acc;
+            }
+
+            const std::size_t num_chunks = num_threads * 4;
+            const std::size_t chunk_size = (size + num_chunks - 1) / num_chunks;
+            // Not std::vector, because std::vector<bool> packs bits and can't be written from several threads.
+            const std::unique_ptr<Acc[]> partials(new Acc[num_chunks]);
+            std::fill_n(partials.get(), num_chunks, Reducer::template identity<InputType>());
+            std::atomic<bool> decided(false);
+
+            parallel::parallel_for(0, num_chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t chunk = begin; chunk < end; ++chunk) {
+                    if constexpr (can_short_circuit<Reducer, Acc>::value) {
+                        if (decided.load(std::memory_order_relaxed)) {
+                            return;
+                        }
+                    }
+
+                    const std::size_t chunk_begin = std::min(chunk * chunk_size, size);
+                    const std::size_t chunk_end = std::min(chunk_begin + chunk_size, size);
+                    Reducer::accumulate(partials[chunk], data + chunk_begin, chunk_end - chunk_begin, 1);
+
+                    if (is_decided<Reducer>(partials[chunk])) {
+                        decided.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+
+            Acc acc = partials[0];
+            for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+                Reducer::merge(acc, partials[chunk]);
+            }
+            return acc;
+        }
+
+        // Accumulates all elements of a strided block, one row of the innermost dimension at a time.
+        template<typename Reducer, typename Acc, typename T>
+        void accumulate_strided(Acc& acc, const T* data, const shape_type& shape, const strides_type& strides) {
+            const std::size_t dimension = shape.size();
+            if (dimension == 0) {
+                Reducer::accumulate(acc, data, 1, 1);
+                return;
+            }
+            if (std::find(shape.begin(), shape.end(), 0) != shape.end()) {
+                return;
+            }
+
+            const std::size_t inner = dimension - 1;
+            shape_type index(inner, 0);
+            std::ptrdiff_t offset = 0;
+
+            while (true) {
+                Reducer::accumulate(acc, data + offset, shape[inner], strides[inner]);
+                if (is_decided<Reducer>(acc)) {
+                    return;
+                }
+
+                // Advance the outer dimensions like an odometer.
+                std::size_t d = inner;
+                while (true) {
+                    if (d == 0) {
+                        return;
+                    }
+                    --d;
+
+                    if (++index[d] < shape[d]) {
+                        offset += strides[d];
+                        break;
+                    }
+
+                    offset -= strides[d] * static_cast<std::ptrdiff_t>(shape[d] - 1);
+                    index[d] = 0;
+                }
+            }
+        }
+
+        // Splits the dimensions of the array into those that are kept and those that are reduced.
+        // Adjacent reduced dimensions that are contiguous with each other are merged, so contiguous blocks are reduced as one row.
+        struct ReductionLayout {
+            shape_type kept_shape;
+            strides_type kept_strides;
+            shape_type reduced_shape;
+            strides_type reduced_strides;
+            std::size_t count = 1;
+
+            template<typename Shape, typename Strides>
+            ReductionLayout(const Shape& shape, const Strides& strides, const shape_type& axes) {
+                for (std::size_t d = 0; d < shape.size(); ++d) {
+                    // Strides of size 1 dimensions are arbitrary, so normalize them.
+                    const std::ptrdiff_t stride = shape[d] == 1 ? 0 : strides[d];
+
+                    if (std::find(axes.begin(), axes.end(), d) == axes.end()) {
+                        kept_shape.push_back(shape[d]);
+                        kept_strides.push_back(stride);
+                        continue;
+                    }
+
+                    count *= shape[d];
+                    if (shape[d] == 1) {
+                        continue;
+                    }
+
+                    if (
+                        !reduced_shape.empty()
+                        && reduced_strides.back() == stride * static_cast<std::ptrdiff_t>(shape[d])
+                        && std::find(axes.begin(), axes.end(), d - 1) != axes.end()
+                    ) {
+                        reduced_shape.back() *= shape[d];
+                        reduced_strides.back() = stride;
+                    } else {
+                        reduced_shape.push_back(shape[d]);
+                        reduced_strides.push_back(stride);
+                    }
+                }
+            }
+        };
+
+        // Reduces the compute case along the axes, and calls write(i, acc) with the accumulator of each output i,
+        //  in the order of the kept dimensions.
+        template<typename Reducer, typename InputType, typename T, typename Write>
+        void reduce_each(const compute_case<T>& carray, const ReductionLayout& layout, const Write& write) {
+            const T* data = carray.data();
+
+            if (layout.kept_shape.empty() && layout.reduced_shape.size() <= 1) {
+                // Full reduction over a contiguous block (or a single strided row).
+                using Acc = typename Reducer::template accumulator<InputType>;
+                Acc acc;
+                if (layout.reduced_shape.empty() || layout.reduced_strides[0] == 1) {
+                    acc = accumulate_flat<Reducer, InputType>(data, layout.count);
+                } else {
+                    acc = Reducer::template identity<InputType>();
+                    Reducer::accumulate(acc, data, layout.reduced_shape[0], layout.reduced_strides[0]);
+                }
+                write(0, acc);
+                return;
+            }
+
+            std::size_t num_outputs = 1;
+            for (const std::size_t size : layout.kept_shape) {
+                num_outputs *= size;
+            }
+
+            const auto reduce_outputs = [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    // Find the first element of this output's block.
+                    std::ptrdiff_t offset = 0;
+                    std::size_t remainder = i;
+                    for (std::size_t d = layout.kept_shape.size(); d-- > 0;) {
+                        offset += static_cast<std::ptrdiff_t>(remainder % layout.kept_shape[d]) * layout.kept_strides[d];
+                        remainder /= layout.kept_shape[d];
+                    }
+
+                    auto acc = Reducer::template identity<InputType>();
+                    accumulate_strided<Reducer>(acc, data + offset, layout.reduced_shape, layout.reduced_strides);
+                    write(i, acc);
+                }
+            };
+
+            if (num_outputs * layout.count >= parallel::get_threshold() && num_outputs > 1) {
+                const std::size_t grain_size = std::max(num_outputs / (parallel::get_num_threads() * 4), static_cast<std::size_t>(1));
+                parallel::parallel_for(0, num_outputs, grain_size, reduce_outputs);
+            } else {
+                reduce_outputs(0, num_outputs);
+            }
+        }
+
+        // Reduces the compute case along the axes, and returns a new store with the kept dimensions.
+        template<typename Reducer, typename InputType, typename OutputType, typename T>
+        store_case<OutputType> reduce_case(const compute_case<T>& carray, const shape_type& axes) {
+            const ReductionLayout layout(carray.shape(), carray.strides(), axes);
+            auto store = make_store<OutputType>(layout.kept_shape);
+            OutputType* output = store->data();
+
+            reduce_each<Reducer, InputType>(carray, layout, [output, &layout](const std::size_t i, const auto& acc) {
+                output[i] = Reducer::template result<OutputType>(acc, layout.count);
+            });
+
+            return store;
+        }
+
+        // Reduces the array along the axes with the Reducer, and assigns the result to the target.
+        // A Reducer defines:
+        // - accumulator<InputType>: the type of intermediate results.
+        // - identity<InputType>(): the accumulator of zero elements.
+        // - accumulate(acc, data, size, stride): adds a strided row of elements to the accumulator.
+        // - merge(acc, other): adds the elements of the other accumulator.
+        // - result<OutputType>(acc, count): the result for an accumulator of count elements.
+        // Elements are converted to InputType as they are read, so arguments of other dtypes are never copied.
+        template<typename Reducer, typename PromotionRule>
+        void reduce_with(VArrayTarget target, const VArray& array, const Axes& axes) {
+            const shape_type normalized_axes = normalize_axes(axes, array.dimension());
+
+            std::visit([target, &normalized_axes](const auto& carray) {
+                using T = typename std::decay_t<decltype(carray)>::value_type;
+                using InputType = typename PromotionRule::template input_type<T>;
+                using OutputType = typename PromotionRule::template output_type<InputType>;
+
+                const auto store = reduce_case<Reducer, InputType, OutputType>(carray, normalized_axes);
+
+                if (const auto new_target = std::get_if<std::optional<VArray>*>(&target)) {
+                    **new_target = from_store(store);
+                } else {
+                    assign_to_target<OutputType>(target, *store);
+                }
+            }, array.to_compute_variant());
+        }
+
+        struct Sum {
+            template<typename InputType>
+            using accumulator = sum_accumulator_t<InputType>;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return 0;
+            }
+
+            template<typename Acc, typename T>
+            static void accumulate(Acc& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                acc += pairwise<Acc>(data, size, stride, Acc(0), [](const Acc a, const Acc b) { return a + b; });
+            }
+
+            template<typename Acc>
+            static void merge(Acc& acc, const Acc& other) {
+                acc += other;
+            }
+
+            template<typename OutputType, typename Acc>
+            static OutputType result(const Acc& acc, std::size_t) {
+                return static_cast<OutputType>(acc);
+            }
+        };
+
+        struct Prod {
+            template<typename InputType>
+            using accumulator = InputType;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return 1;
+            }
+
+            template<typename Acc, typename T>
+            static void accumulate(Acc& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                acc *= pairwise<Acc>(data, size, stride, Acc(1), [](const Acc a, const Acc b) { return a * b; });
+            }
+
+            template<typename Acc>
+            static void merge(Acc& acc, const Acc& other) {
+                acc *= other;
+            }
+
+            template<typename OutputType, typename Acc>
+            static OutputType result(const Acc& acc, std::size_t) {
+                return static_cast<OutputType>(acc);
+            }
+        };
+
+        struct Mean : Sum {
+            template<typename OutputType, typename Acc>
+            static OutputType result(const Acc& acc, const std::size_t count) {
+                return static_cast<OutputType>(acc / static_cast<Acc>(count));
+            }
+        };
+
+        // Count, mean and sum of squared deviations from the mean, of some elements.
+        // The count is an integer, so it stays exact for float32 too, and is only rounded where it's used.
+        template<typename F>
+        struct Moments {
+            std::size_t count = 0;
+            F mean = 0;
+            F m2 = 0;
+
+            // Chan et al.'s update for the union of both element sets.
+            void merge(const Moments& other) {
+                if (other.count == 0) {
+                    return;
+                }
+                if (count == 0) {
+                    *this = other;
+                    return;
+                }
+
+                const std::size_t total = count + other.count;
+                const F delta = other.mean - mean;
+                const F other_weight = static_cast<F>(static_cast<double>(other.count) / static_cast<double>(total));
+                mean += delta * other_weight;
+                m2 += other.m2 + delta * delta * (static_cast<F>(count) * other_weight);
+                count = total;
+            }
+        };
+
+        // Sum of squared deviations from the mean, in 8 independent lanes.
+        template<typename F, typename T>
+        F squared_deviations(const T* data, const std::size_t size, const std::ptrdiff_t stride, const F mean) {
+            constexpr std::size_t lanes = 8;
+            F lane[lanes] = {};
+
+            std::size_t i = 0;
+            for (; i + lanes <= size; i += lanes) {
+                for (std::size_t j = 0; j < lanes; ++j) {
+                    const F deviation = static_cast<F>(data[static_cast<std::ptrdiff_t>(i + j) * stride]) - mean;
+                    lane[j] += deviation * deviation;
+                }
+            }
+
+            F result = ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+            for (; i < size; ++i) {
+                const F deviation = static_cast<F>(data[static_cast<std::ptrdiff_t>(i) * stride]) - mean;
+                result += deviation * deviation;
+            }
+            return result;
+        }
+
+        // Computes mean and variance in a single pass over memory, merging the partial results of blocks and threads.
+        // Rows are processed in small blocks: the block's mean and squared deviations are computed while the block is
+        //  in cache, then merged into the accumulator (Welford / Chan). This is stable even when the mean is large.
+        struct Variance {
+            static constexpr std::size_t block_size = 256;
+
+            template<typename InputType>
+            using accumulator = Moments<InputType>;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return {};
+            }
+
+            template<typename F, typename T>
+            static void accumulate(Moments<F>& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                for (std::size_t begin = 0; begin < size; begin += block_size) {
+                    const std::size_t block = std::min(block_size, size - begin);
+                    const T* block_data = data + static_cast<std::ptrdiff_t>(begin) * stride;
+
+                    Moments<F> moments;
+                    moments.count = block;
+                    moments.mean = pairwise<F>(block_data, block, stride, F(0), [](const F a, const F b) { return a + b; }) / static_cast<F>(block);
+                    moments.m2 = squared_deviations(block_data, block, stride, moments.mean);
+                    acc.merge(moments);
+                }
+            }
+
+            template<typename F>
+            static void merge(Moments<F>& acc, const Moments<F>& other) {
+                acc.merge(other);
+            }
+
+            // The population variance, like NumPy with ddof=0.
+            template<typename OutputType, typename F>
+            static OutputType result(const Moments<F>& acc, std::size_t) {
+                return static_cast<OutputType>(acc.m2 / static_cast<F>(acc.count));
+            }
+        };
+
+        struct Std : Variance {
+            template<typename OutputType, typename F>
+            static OutputType result(const Moments<F>& acc, std::size_t) {
+                return static_cast<OutputType>(std::sqrt(acc.m2 / static_cast<F>(acc.count)));
+            }
+        };
+
+        // Minimum and maximum in M, and the moments in F, of some elements.
+        template<typename M, typename F>
+        struct Statistics {
+            using min_type = M;
+            using float_type = F;
+
+            M min;
+            M max;
+            Moments<F> moments;
+        };
+
+        template<typename T>
+        bool is_nan(const T value) {
+            if constexpr (std::is_floating_point_v<T>) {
+                return value != value;
+            } else {
+                return false;
+            }
+        }
+
+        // Computes min, max, mean and variance in a single pass over memory.
+        // Each block is scanned for min and max, then its moments are merged like in Variance, while it is in cache.
+        // There is no result(), because each statistic is written to its own output; see va::moments.
+        struct Describe {
+            template<typename InputType>
+            using accumulator = Statistics<
+                typename promote::num_common_type::template input_type<InputType>,
+                typename promote::num_matching_float_or_default<double_t>::template input_type<InputType>
+            >;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                using M = typename accumulator<InputType>::min_type;
+                return { std::numeric_limits<M>::max(), std::numeric_limits<M>::lowest(), {} };
+            }
+
+            template<typename M, typename F, typename T>
+            static void accumulate(Statistics<M, F>& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                for (std::size_t begin = 0; begin < size; begin += Variance::block_size) {
+                    const std::size_t block = std::min(Variance::block_size, size - begin);
+                    const T* block_data = data + static_cast<std::ptrdiff_t>(begin) * stride;
+
+                    M min = acc.min;
+                    M max = acc.max;
+                    bool has_nan = false;
+                    for (std::size_t i = 0; i < block; ++i) {
+                        const M value = static_cast<M>(block_data[static_cast<std::ptrdiff_t>(i) * stride]);
+                        min = value < min ? value : min;
+                        max = value > max ? value : max;
+                        has_nan |= is_nan(value);
+                    }
+                    // Comparisons skip NaN, but it propagates into min and max like into mean and variance.
+                    // Once they are NaN, they stay NaN, because no value compares less or greater.
+                    if (has_nan) {
+                        min = std::numeric_limits<M>::quiet_NaN();
+                        max = std::numeric_limits<M>::quiet_NaN();
+                    }
+                    acc.min = min;
+                    acc.max = max;
+
+                    Variance::accumulate(acc.moments, block_data, block, stride);
+                }
+            }
+
+            template<typename M, typename F>
+            static void merge(Statistics<M, F>& acc, const Statistics<M, F>& other) {
+                if (is_nan(acc.min) || is_nan(other.min)) {
+                    acc.min = std::numeric_limits<M>::quiet_NaN();
+                    acc.max = std::numeric_limits<M>::quiet_NaN();
+                } else {
+                    acc.min = std::min(acc.min, other.min);
+                    acc.max = std::max(acc.max, other.max);
+                }
+                acc.moments.merge(other.moments);
+            }
+        };
+
+        // Whether any of size elements is non-zero. Bools are read 32 bytes at a time.
+        template<typename T>
+        bool any_nonzero(const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+            std::size_t i = 0;
+
+            if constexpr (std::is_same_v<T, bool> && sizeof(bool) == 1) {
+                if (stride == 1) {
+                    const auto bytes = reinterpret_cast<const unsigned char*>(data);
+                    for (; i + 32 <= size; i += 32) {
+                        std::uint64_t words[4];
+                        std::memcpy(words, bytes + i, sizeof(words));
+                        if ((words[0] | words[1]) | (words[2] | words[3])) {
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            // Check blocks at once, so the comparisons can be vectorized.
+            constexpr std::size_t block_size = 64;
+            for (; i < size; i += block_size) {
+                const std::size_t block_end = std::min(i + block_size, size);
+                bool found = false;
+                for (std::size_t j = i; j < block_end; ++j) {
+                    found |= data[static_cast<std::ptrdiff_t>(j) * stride] != T(0);
+                }
+                if (found) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Whether all of size elements are non-zero. Bools are read 32 bytes at a time.
+        template<typename T>
+        bool all_nonzero(const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+            std::size_t i = 0;
+
+            if constexpr (std::is_same_v<T, bool> && sizeof(bool) == 1) {
+                if (stride == 1) {
+                    // true is stored as 1, so all are true only if every byte is 1.
+                    constexpr std::uint64_t ones = 0x0101010101010101;
+                    const auto bytes = reinterpret_cast<const unsigned char*>(data);
+                    for (; i + 32 <= size; i += 32) {
+                        std::uint64_t words[4];
+                        std::memcpy(words, bytes + i, sizeof(words));
+                        if (((words[0] ^ ones) | (words[1] ^ ones)) | ((words[2] ^ ones) | (words[3] ^ ones))) {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            constexpr std::size_t block_size = 64;
+            for (; i < size; i += block_size) {
+                const std::size_t block_end = std::min(i + block_size, size);
+                bool found = false;
+                for (std::size_t j = i; j < block_end; ++j) {
+                    found |= data[static_cast<std::ptrdiff_t>(j) * stride] == T(0);
+                }
+                if (found) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Any and All stop reading as soon as the result is known, e.g. at the first true element for Any.
+        struct Any {
+            template<typename InputType>
+            using accumulator = bool;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return false;
+            }
+
+            template<typename T>
+            static void accumulate(bool& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                acc = acc || any_nonzero(data, size, stride);
+            }
+
+            static void merge(bool& acc, const bool other) {
+                acc = acc || other;
+            }
+
+            static bool is_decided(const bool acc) {
+                return acc;
+            }
+
+            template<typename OutputType>
+            static OutputType result(const bool acc, std::size_t) {
+                return acc;
+            }
+        };
+
+        struct All {
+            template<typename InputType>
+            using accumulator = bool;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return true;
+            }
+
+            template<typename T>
+            static void accumulate(bool& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                acc = acc && all_nonzero(data, size, stride);
+            }
+
+            static void merge(bool& acc, const bool other) {
+                acc = acc && other;
+            }
+
+            static bool is_decided(const bool acc) {
+                return !acc;
+            }
+
+            template<typename OutputType>
+            static OutputType result(const bool acc, std::size_t) {
+                return acc;
+            }
+        };
+
+        // The best value of some elements, and the flat index of its first occurrence.
+        template<typename T>
+        struct IndexedValue {
+            T value;
+            // -1 as long as no elements were seen.
+            std::int64_t index;
+            // The number of elements seen, which is the offset of the next element.
+            std::int64_t count;
+        };
+
+        // Finds the first index of the best element, where Compare::better(a, b) tells if a is better than b.
+        // Each block's best value is found in independent lanes first, and only searched for if it beats the current one.
+        template<typename Compare>
+        struct ArgBest {
+            static constexpr std::size_t block_size = 256;
+
+            template<typename InputType>
+            using accumulator = IndexedValue<InputType>;
+
+            template<typename InputType>
+            static accumulator<InputType> identity() {
+                return { InputType(), -1, 0 };
+            }
+
+            template<typename V, typename T>
+            static void accumulate(IndexedValue<V>& acc, const T* data, const std::size_t size, const std::ptrdiff_t stride) {
+                constexpr std::size_t lanes = 8;
+                const auto at = [data, stride](const std::size_t i) {
+                    return static_cast<V>(data[static_cast<std::ptrdiff_t>(i) * stride]);
+                };
+
+                for (std::size_t begin = 0; begin < size; begin += block_size) {
+                    const std::size_t end = std::min(begin + block_size, size);
+
+                    V lane[lanes];
+                    std::fill_n(lane, lanes, at(begin));
+                    std::size_t i = begin;
+                    for (; i + lanes <= end; i += lanes) {
+                        for (std::size_t j = 0; j < lanes; ++j) {
+                            const V value = at(i + j);
+                            lane[j] = Compare::better(value, lane[j]) ? value : lane[j];
+                        }
+                    }
+                    for (; i < end; ++i) {
+                        const V value = at(i);
+                        lane[0] = Compare::better(value, lane[0]) ? value : lane[0];
+                    }
+
+                    V best = lane[0];
+                    for (std::size_t j = 1; j < lanes; ++j) {
+                        best = Compare::better(lane[j], best) ? lane[j] : best;
+                    }
+
+                    if (acc.index >= 0 && !Compare::better(best, acc.value)) {
+                        continue;
+                    }
+
+                    std::size_t position = begin;
+                    while (!(at(position) == best || (is_nan(best) && is_nan(at(position))))) {
+                        ++position;
+                    }
+                    acc.value = best;
+                    acc.index = acc.count + static_cast<std::int64_t>(position);
+                }
+
+                acc.count += static_cast<std::int64_t>(size);
+            }
+
+            template<typename V>
+            static void merge(IndexedValue<V>& acc, const IndexedValue<V>& other) {
+                if (other.index >= 0 && (acc.index < 0 || Compare::better(other.value, acc.value))) {
+                    acc.value = other.value;
+                    acc.index = acc.count + other.index;
+                }
+                acc.count += other.count;
+            }
+
+            template<typename OutputType, typename V>
+            static OutputType result(const IndexedValue<V>& acc, std::size_t) {
+                if (acc.index < 0) {
+                    throw std::runtime_error("Cannot find the index of the best element of zero elements.");
+                }
+                return static_cast<OutputType>(acc.index);
+            }
+        };
+
+        // NaN is better than any other value, like in NumPy.
+        struct Greater {
+            template<typename T>
+            static bool better(const T a, const T b) {
+                return a > b || (is_nan(a) && !is_nan(b));
+            }
+        };
+
+        struct Less {
+            template<typename T>
+            static bool better(const T a, const T b) {
+                return a < b || (is_nan(a) && !is_nan(b));
+            }
+        };
+
+        using ArgMax = ArgBest<Greater>;
+        using ArgMin = ArgBest<Less>;
+
+        // Whether the element at index a comes before the one at index b, in descending order.
+        // NaN comes first, like it is the largest value; equal elements keep their order.
+        template<typename T>
+        bool is_before_descending(const T a, const T b, const std::size_t index_a, const std::size_t index_b) {
+            if (is_nan(a) || is_nan(b)) {
+                return is_nan(a) && (!is_nan(b) || index_a < index_b);
+            }
+            if (a != b) {
+                return a > b;
+            }
+            return index_a < index_b;
+        }
+
+        // Writes the indices of the k largest elements of each line along the axis, from largest to smallest.
+        // nth_element selects them in O(n), so only the k selected indices are sorted.
+        template<typename T, typename OutputStrides>
+        void select_top_k(std::int64_t* output, const OutputStrides& output_strides, const compute_case<T>& carray, const std::size_t k, const std::size_t axis) {
+            const auto& shape = carray.shape();
+            const auto& strides = carray.strides();
+            const std::size_t size = shape[axis];
+            const std::ptrdiff_t stride = strides[axis];
+            const std::ptrdiff_t output_stride = output_strides[axis];
+            const T* data = carray.data();
+
+            std::size_t num_lines = 1;
+            for (std::size_t d = 0; d < shape.size(); ++d) {
+                if (d != axis) {
+                    num_lines *= shape[d];
+                }
+            }
+            if (k == 0 || num_lines == 0) {
+                return;
+            }
+
+            const auto select_lines = [&](const std::size_t begin, const std::size_t end) {
+                std::vector<std::size_t> indices(size);
+
+                for (std::size_t line = begin; line < end; ++line) {
+                    std::ptrdiff_t offset = 0;
+                    std::ptrdiff_t output_offset = 0;
+                    std::size_t remainder = line;
+                    for (std::size_t d = shape.size(); d-- > 0;) {
+                        if (d == axis) {
+                            continue;
+                        }
+                        const auto index = static_cast<std::ptrdiff_t>(remainder % shape[d]);
+                        remainder /= shape[d];
+                        offset += index * strides[d];
+                        output_offset += index * output_strides[d];
+                    }
+
+                    const T* line_data = data + offset;
+                    const auto is_before = [line_data, stride](const std::size_t a, const std::size_t b) {
+                        return is_before_descending(
+                            line_data[static_cast<std::ptrdiff_t>(a) * stride],
+                            line_data[static_cast<std::ptrdiff_t>(b) * stride],
+                            a, b
+                        );
+                    };
+
+                    std::iota(indices.begin(), indices.end(), std::size_t(0));
+                    if (k < size) {
+                        std::nth_element(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k - 1), indices.end(), is_before);
+                    }
+                    std::sort(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k), is_before);
+
+                    for (std::size_t j = 0; j < k; ++j) {
+                        output[output_offset + static_cast<std::ptrdiff_t>(j) * output_stride] = static_cast<std::int64_t>(indices[j]);
+                    }
+                }
+            };
+
+            if (num_lines * size >= parallel::get_threshold() && num_lines > 1) {
+                const std::size_t grain_size = std::max(num_lines / (parallel::get_num_threads() * 4), static_cast<std::size_t>(1));
+                parallel::parallel_for(0, num_lines, grain_size, select_lines);
+            } else {
+                select_lines(0, num_lines);
+            }
+        }
+    }
+}
+
+#endif //VREDUCE_H
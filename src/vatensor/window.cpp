@@ -0,0 +1,262 @@
+#include "window.h"
+
+#include <algorithm>                                    // for max
+#include <cmath>                                        // for abs, double_t, isinf, isnan
+#include <cstddef>                                      // for size_t, ptrdiff_t
+#include <limits>                                       // for numeric_limits
+#include <optional>                                     // for optional
+#include <stdexcept>                                    // for runtime_error
+#include <type_traits>                                  // for conditional_t, decay_t, is_floating_point_v
+#include <variant>                                      // for visit, get_if
+#include <vector>                                       // for vector
+#include "vcompute.h"                                   // for assign_to_target
+#include "vparallel.h"                                  // for parallel_for, get_threshold, get_num_threads
+#include "vpromote.h"                                   // for num_common_type, num_matching_float_or_default
+#include "vreduce.h"                                    // for normalize_axes, sum_accumulator_t, Greater, Less
+
+using namespace va;
+
+namespace {
+	// The sum of the finite elements in a window, and the number of non-finite ones.
+	// Non-finite elements are counted instead of summed, because subtracting them again would give NaN.
+	// The sum uses Neumaier's compensation, so a large element doesn't wipe out the small ones after it.
+	struct FloatWindowSum {
+		double_t sum = 0;
+		double_t compensation = 0;
+		std::size_t num_nan = 0;
+		std::size_t num_positive_inf = 0;
+		std::size_t num_negative_inf = 0;
+
+		void add(const double_t value) {
+			if (std::isnan(value)) {
+				++num_nan;
+			} else if (std::isinf(value)) {
+				++(value > 0 ? num_positive_inf : num_negative_inf);
+			} else {
+				accumulate(value);
+			}
+		}
+
+		void remove(const double_t value) {
+			if (std::isnan(value)) {
+				--num_nan;
+			} else if (std::isinf(value)) {
+				--(value > 0 ? num_positive_inf : num_negative_inf);
+			} else {
+				accumulate(-value);
+			}
+		}
+
+		void accumulate(const double_t value) {
+			const double_t total = sum + value;
+			compensation += std::abs(sum) >= std::abs(value) ? (sum - total) + value : (value - total) + sum;
+			sum = total;
+		}
+
+		[[nodiscard]] double_t value() const {
+			if (num_nan > 0 || (num_positive_inf > 0 && num_negative_inf > 0)) {
+				return std::numeric_limits<double_t>::quiet_NaN();
+			}
+			if (num_positive_inf > 0) {
+				return std::numeric_limits<double_t>::infinity();
+			}
+			if (num_negative_inf > 0) {
+				return -std::numeric_limits<double_t>::infinity();
+			}
+			return sum + compensation;
+		}
+	};
+
+	// Each step adds the element entering the window and subtracts the one leaving it, so each line is one pass.
+	// Integers are summed exactly. Floats are summed in a FloatWindowSum, whose rounding errors would still add up
+	//  over long lines, so it is recomputed from the elements of the window every window steps.
+	template <bool DivideByWindow>
+	struct RunningSum {
+		template <typename InputType, typename O, typename T>
+		static void line(O* out, const std::ptrdiff_t out_stride, const T* in, const std::ptrdiff_t stride, const std::size_t size, const std::size_t window, std::vector<std::size_t>&) {
+			using Acc = std::conditional_t<std::is_floating_point_v<InputType>, double_t, reduce::sum_accumulator_t<InputType>>;
+
+			const auto at = [in, stride](const std::size_t i) {
+				return static_cast<Acc>(static_cast<InputType>(in[static_cast<std::ptrdiff_t>(i) * stride]));
+			};
+			const auto result = [window](const Acc acc) {
+				if constexpr (DivideByWindow) {
+					return static_cast<O>(acc / static_cast<Acc>(window));
+				} else {
+					return static_cast<O>(acc);
+				}
+			};
+
+			if constexpr (std::is_floating_point_v<InputType>) {
+				FloatWindowSum acc;
+				for (std::size_t i = 0; i < window; ++i) {
+					acc.add(at(i));
+				}
+				out[0] = result(acc.value());
+
+				for (std::size_t i = window; i < size; ++i) {
+					const std::size_t first = i + 1 - window;
+					if (first % window == 0) {
+						acc = {};
+						for (std::size_t j = first; j <= i; ++j) {
+							acc.add(at(j));
+						}
+					} else {
+						acc.add(at(i));
+						acc.remove(at(i - window));
+					}
+					out[static_cast<std::ptrdiff_t>(first) * out_stride] = result(acc.value());
+				}
+			} else {
+				Acc acc = 0;
+				for (std::size_t i = 0; i < window; ++i) {
+					acc += at(i);
+				}
+				out[0] = result(acc);
+
+				for (std::size_t i = window; i < size; ++i) {
+					acc += at(i);
+					acc -= at(i - window);
+					out[static_cast<std::ptrdiff_t>(i + 1 - window) * out_stride] = result(acc);
+				}
+			}
+		}
+	};
+
+	// Keeps the indices of the elements that can still become the best in a monotonic deque, best first.
+	// Each index is pushed and popped at most once, so each line is one pass regardless of the window size.
+	template <typename Compare>
+	struct RunningBest {
+		template <typename InputType, typename O, typename T>
+		static void line(O* out, const std::ptrdiff_t out_stride, const T* in, const std::ptrdiff_t stride, const std::size_t size, const std::size_t window, std::vector<std::size_t>& deque) {
+			const auto at = [in, stride](const std::size_t i) {
+				return static_cast<InputType>(in[static_cast<std::ptrdiff_t>(i) * stride]);
+			};
+
+			// Indices are only ever appended, so the deque never needs to wrap around.
+			deque.resize(size);
+			std::size_t head = 0;
+			std::size_t tail = 0;
+
+			for (std::size_t i = 0; i < size; ++i) {
+				const InputType value = at(i);
+				while (tail > head && !Compare::better(at(deque[tail - 1]), value)) {
+					--tail;
+				}
+				deque[tail++] = i;
+
+				if (deque[head] + window <= i) {
+					++head;
+				}
+				if (i + 1 >= window) {
+					out[static_cast<std::ptrdiff_t>(i + 1 - window) * out_stride] = static_cast<O>(at(deque[head]));
+				}
+			}
+		}
+	};
+
+	using MovingSum = RunningSum<false>;
+	using MovingMean = RunningSum<true>;
+	using MovingMin = RunningBest<reduce::Less>;
+	using MovingMax = RunningBest<reduce::Greater>;
+
+	template <typename Kernel, typename PromotionRule>
+	void moving(VArrayTarget target, const VArray& array, const std::size_t window, const std::ptrdiff_t axis) {
+		const std::size_t window_axis = reduce::normalize_axes(GivenAxes { axis }, array.dimension())[0];
+		if (window == 0 || window > array.shape[window_axis]) {
+			throw std::runtime_error("The window must be between 1 and the size of the axis.");
+		}
+
+		std::visit([target, window, window_axis](const auto& carray) {
+			using T = typename std::decay_t<decltype(carray)>::value_type;
+			using InputType = typename PromotionRule::template input_type<T>;
+			using OutputType = typename PromotionRule::template output_type<InputType>;
+
+			const auto& shape = carray.shape();
+			const auto& strides = carray.strides();
+			const std::size_t size = shape[window_axis];
+
+			shape_type result_shape(shape.begin(), shape.end());
+			result_shape[window_axis] = size - window + 1;
+			const auto store = make_store<OutputType>(result_shape);
+			const auto& result_strides = store->strides();
+
+			std::size_t num_lines = 1;
+			for (std::size_t d = 0; d < shape.size(); ++d) {
+				if (d != window_axis) {
+					num_lines *= shape[d];
+				}
+			}
+
+			const auto compute_lines = [&](const std::size_t begin, const std::size_t end) {
+				std::vector<std::size_t> scratch;
+
+				for (std::size_t line = begin; line < end; ++line) {
+					std::ptrdiff_t offset = 0;
+					std::ptrdiff_t result_offset = 0;
+					std::size_t remainder = line;
+					for (std::size_t d = shape.size(); d-- > 0;) {
+						if (d == window_axis) {
+							continue;
+						}
+						const auto index = static_cast<std::ptrdiff_t>(remainder % shape[d]);
+						remainder /= shape[d];
+						offset += index * strides[d];
+						result_offset += index * result_strides[d];
+					}
+
+					Kernel::template line<InputType>(
+						store->data() + result_offset, result_strides[window_axis],
+						carray.data() + offset, strides[window_axis],
+						size, window, scratch
+					);
+				}
+			};
+
+			if (num_lines * size >= parallel::get_threshold() && num_lines > 1) {
+				const std::size_t grain_size = std::max(num_lines / (parallel::get_num_threads() * 4), static_cast<std::size_t>(1));
+				parallel::parallel_for(0, num_lines, grain_size, compute_lines);
+			} else {
+				compute_lines(0, num_lines);
+			}
+
+			if (const auto new_target = std::get_if<std::optional<VArray>*>(&target)) {
+				**new_target = from_store(store);
+			} else {
+				assign_to_target<OutputType>(target, *store);
+			}
+		}, array.to_compute_variant());
+	}
+}
+
+void va::moving_sum(VArrayTarget target, const VArray& array, const std::size_t window, const std::ptrdiff_t axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	moving<MovingSum, promote::num_common_type>(target, array, window, axis);
+#endif
+}
+
+void va::moving_mean(VArrayTarget target, const VArray& array, const std::size_t window, const std::ptrdiff_t axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	moving<MovingMean, promote::num_matching_float_or_default<double_t>>(target, array, window, axis);
+#endif
+}
+
+void va::moving_min(VArrayTarget target, const VArray& array, const std::size_t window, const std::ptrdiff_t axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	moving<MovingMin, promote::num_common_type>(target, array, window, axis);
+#endif
+}
+
+void va::moving_max(VArrayTarget target, const VArray& array, const std::size_t window, const std::ptrdiff_t axis) {
+#ifdef NUMDOT_DISABLE_REDUCTION_FUNCTIONS
+	throw std::runtime_error("function explicitly disabled; recompile without NUMDOT_DISABLE_REDUCTION_FUNCTIONS to enable it.");
+#else
+	moving<MovingMax, promote::num_common_type>(target, array, window, axis);
+#endif
+}
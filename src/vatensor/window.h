@@ -0,0 +1,17 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include "auto_defines.h"
+#include <cstddef>   // for size_t, ptrdiff_t
+#include "varray.h"
+
+namespace va {
+    // Reductions over each window of consecutive elements along the axis.
+    // The axis of the result has size - window + 1 elements, one for each window that fits entirely.
+    void moving_sum(VArrayTarget target, const VArray& array, std::size_t window, std::ptrdiff_t axis);
+    void moving_mean(VArrayTarget target, const VArray& array, std::size_t window, std::ptrdiff_t axis);
+    void moving_min(VArrayTarget target, const VArray& array, std::size_t window, std::ptrdiff_t axis);
+    void moving_max(VArrayTarget target, const VArray& array, std::size_t window, std::ptrdiff_t axis);
+}
+
+#endif //WINDOW_H